@@ -12,19 +12,32 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 */
 
 #include "RunebergVRPlugin.h"
+#include "RunebergVR_TeleportAnchor.h"
+#include "RunebergVR_MovementBatcher.h"
+#include "Engine/World.h"
 
 
 #define LOCTEXT_NAMESPACE "FRunebergVRPluginModule"
 
+// Release per-world plugin data when its world goes away
+static void CleanupWorldData(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+	FRunebergVRTeleportAnchorHash::OnWorldCleanup(World, bSessionEnded, bCleanupResources);
+	FRunebergVRMovementBatcher::OnWorldCleanup(World, bSessionEnded, bCleanupResources);
+}
+
 void FRunebergVRPluginModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+
+	WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddStatic(&CleanupWorldData);
 }
 
 void FRunebergVRPluginModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+	FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
 }
 
 #undef LOCTEXT_NAMESPACE
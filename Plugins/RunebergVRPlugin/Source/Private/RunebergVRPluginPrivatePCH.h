@@ -17,7 +17,12 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include "RunebergVR_Grabber.h"
 #include "RunebergVR_SimpleGrabber.h"
 #include "RunebergVR_Movement.h"
+#include "RunebergVR_MovementBatcher.h"
+#include "RunebergVR_FixedTimestep.h"
 #include "RunebergVR_Teleporter.h"
+#include "RunebergVR_TeleportGrid.h"
+#include "RunebergVR_TeleportAnchor.h"
+#include "RunebergVR_Tags.h"
 #include "RunebergVR_Climb.h"
 #include "RunebergVR_CustomGravity.h"
 #include "RunebergVR_ScalableMesh.h"
@@ -1,6 +1,7 @@
 // Copyright (C) 2017 Runeberg (github: 1runeberg, UE4 Forums: runeberg)
 
 #include "RunebergVR_Climb.h"
+#include "RunebergVR_Tags.h"
 
 // Sets default values for this component's properties
 URunebergVR_Climb::URunebergVR_Climb()
@@ -10,6 +11,14 @@ URunebergVR_Climb::URunebergVR_Climb()
 	PrimaryComponentTick.bCanEverTick = true;
 }
 
+// Called when the game starts
+void URunebergVR_Climb::BeginPlay()
+{
+	Super::BeginPlay();
+
+	ClimbTagSet.Append(ClimbTags);
+}
+
 // Called every frame
 void URunebergVR_Climb::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
@@ -53,17 +62,11 @@ void URunebergVR_Climb::Climb()
 
 			for (int32 i = 0; i < OverlappingComponents.Num(); i++)
 			{
-				if (OverlappingComponents[i])
+				// Check this component for defined climb tags
+				if (FRunebergVRTags::HasAnyTag(OverlappingComponents[i], ClimbTagSet))
 				{
-					// Check this component for defined climb tags
-					for (int32 j = 0; j < ClimbTags.Num(); j++)
-					{
-						if (OverlappingComponents[j]->ComponentHasTag(ClimbTags[j]))
-						{
-							StartClimb(ClimbingReference);
-							return;
-						}
-					}
+					StartClimb(ClimbingReference);
+					return;
 				}
 			}
 
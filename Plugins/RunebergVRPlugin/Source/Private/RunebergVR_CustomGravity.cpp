@@ -1,6 +1,7 @@
 // Copyright (C) 2017 Runeberg (github: 1runeberg, UE4 Forums: runeberg)
 
 #include "RunebergVR_CustomGravity.h"
+#include "RunebergVR_Tags.h"
 
 
 // Sets default values for this component's properties
@@ -12,6 +13,15 @@ URunebergVR_CustomGravity::URunebergVR_CustomGravity()
 
 }
 
+// Called when the game starts
+void URunebergVR_CustomGravity::BeginPlay()
+{
+	Super::BeginPlay();
+
+	StopTagSet.Append(StopTags);
+	StartTagSet.Append(StartTags);
+}
+
 // Called every frame
 void URunebergVR_CustomGravity::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
@@ -20,60 +30,69 @@ void URunebergVR_CustomGravity::TickComponent(float DeltaTime, ELevelTick TickTy
 	// Move this actor to the direction of gravity
 	if (IsGravityActive)
 	{
+		// One gravity step per tick unless a fixed step rate is set
+		GravityTimestep.SetRate(FixedStepRate);
+		const int32 Steps = GravityTimestep.Advance(DeltaTime);
 
-		switch (GravityDirection)
+		USceneComponent* Root = GetOwner()->GetRootComponent();
+		FVector SimLocation = GravityInterpolation.GetSimLocation(Root->RelativeLocation);
+		for (int32 Step = 0; Step < Steps; Step++)
 		{
-		case EGravityDirection ::DIR_DOWN:
-			GetOwner()->GetRootComponent()->AddRelativeLocation(FVector(0.0f, 0.0f, -1.0f * GravityStrength ));
-			break;
-		case EGravityDirection::DIR_UP:
-			GetOwner()->GetRootComponent()->AddRelativeLocation(FVector(0.0f, 0.0f, 1.0f * GravityStrength));
-			break;
-		case EGravityDirection::DIR_LEFT:
-			GetOwner()->GetRootComponent()->AddRelativeLocation(FVector(0.0f, 1.0f * GravityStrength, 0.0f));
-			break;
-		case EGravityDirection::DIR_RIGHT:
-			GetOwner()->GetRootComponent()->AddRelativeLocation(FVector(0.0f, -1.0f * GravityStrength, 0.0f));
-			break;
-		case EGravityDirection::DIR_FORWARD:
-			GetOwner()->GetRootComponent()->AddRelativeLocation(FVector(-1.0f * GravityStrength, 0.0f, 0.0f));
-			break;
-		case EGravityDirection::DIR_BACK:
-			GetOwner()->GetRootComponent()->AddRelativeLocation(FVector(1.0f * GravityStrength, 0.0f, 0.0f));
-			break;
-		case EGravityDirection::DIR_RELATIVE:
-			GetOwner()->GetRootComponent()->AddRelativeLocation((GravityOrigin - (GetOwner()->GetActorLocation()).GetSafeNormal()) * FVector(GravityStrength, GravityStrength, GravityStrength));
-			break;
-		default:
-			break;
+			const FVector StepDelta = GetGravityStep() * GravityTimestep.GetStepScale();
+			GravityInterpolation.AddStep(StepDelta);
+			SimLocation += StepDelta;
 		}
-	
 
+		Root->SetRelativeLocation(GravityInterpolation.GetDrawLocation(SimLocation, GravityTimestep.GetAlpha()));
+	}
+	else if (!GravityInterpolation.Lag.IsZero())
+	{
+		// Gravity stopped - catch up with where the simulation ended
+		USceneComponent* Root = GetOwner()->GetRootComponent();
+		Root->SetRelativeLocation(GravityInterpolation.GetSimLocation(Root->RelativeLocation));
+		GravityInterpolation.Reset();
+		GravityTimestep.Reset(true);
+	}
+}
+
+// Movement of one gravity step
+FVector URunebergVR_CustomGravity::GetGravityStep() const
+{
+	switch (GravityDirection)
+	{
+	case EGravityDirection ::DIR_DOWN:
+		return FVector(0.0f, 0.0f, -1.0f * GravityStrength );
+	case EGravityDirection::DIR_UP:
+		return FVector(0.0f, 0.0f, 1.0f * GravityStrength);
+	case EGravityDirection::DIR_LEFT:
+		return FVector(0.0f, 1.0f * GravityStrength, 0.0f);
+	case EGravityDirection::DIR_RIGHT:
+		return FVector(0.0f, -1.0f * GravityStrength, 0.0f);
+	case EGravityDirection::DIR_FORWARD:
+		return FVector(-1.0f * GravityStrength, 0.0f, 0.0f);
+	case EGravityDirection::DIR_BACK:
+		return FVector(1.0f * GravityStrength, 0.0f, 0.0f);
+	case EGravityDirection::DIR_RELATIVE:
+		return (GravityOrigin - (GetOwner()->GetActorLocation()).GetSafeNormal()) * FVector(GravityStrength, GravityStrength, GravityStrength);
+	default:
+		return FVector::ZeroVector;
 	}
 }
 
 /** Stop or Start Gravity if collided component or actor has the corresponding start/stop tag */
 void URunebergVR_CustomGravity::ProcessTags(AActor* OtherActor,  UPrimitiveComponent* OtherComp)
 {
-
 	// Check whether to stop gravity
-	for (int32 i = 0; i < StopTags.Num(); i++)
+	if (FRunebergVRTags::HasAnyTag(OtherActor, StopTagSet) || FRunebergVRTags::HasAnyTag(OtherComp, StopTagSet))
 	{
-		if ((OtherActor && OtherActor->ActorHasTag(StopTags[i])) || (OtherComp && OtherComp->ComponentHasTag(StopTags[i])))
-		{
-			IsGravityActive = false;
-			return;
-		}
+		IsGravityActive = false;
+		return;
 	}
 
 	// Check whether to start gravity
-	for (int32 i = 0; i < StartTags.Num(); i++)
+	if (FRunebergVRTags::HasAnyTag(OtherActor, StartTagSet) || FRunebergVRTags::HasAnyTag(OtherComp, StartTagSet))
 	{
-		if ((OtherActor && OtherActor->ActorHasTag(StartTags[i])) || (OtherComp && OtherComp->ComponentHasTag(StartTags[i])))
-		{
-			IsGravityActive = true;
-			return;
-		}
+		IsGravityActive = true;
 	}
 }
 
@@ -12,6 +12,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 */
 
 #include "RunebergVR_Gaze.h"
+#include "RunebergVR_Tags.h"
 #include "Kismet/KismetSystemLibrary.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "IHeadMountedDisplay.h"
@@ -68,7 +69,7 @@ void URunebergVR_Gaze::TickComponent(float DeltaTime, ELevelTick TickType, FActo
 		{
 
 			// Check for tag
-			if (!FrontGazeVariables.TargetTag.IsNone() && !Hit.GetActor()->ActorHasTag(FrontGazeVariables.TargetTag))
+			if (!FrontGazeVariables.TargetTag.IsNone() && !FRunebergVRTags::HasTag(Hit.GetActor(), FrontGazeVariables.TargetTag))
 			{
 				return;
 			}
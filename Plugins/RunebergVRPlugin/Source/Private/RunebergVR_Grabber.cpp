@@ -12,7 +12,42 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 */
 
 #include "RunebergVR_Grabber.h"
+#include "RunebergVR_Tags.h"
 #include "Kismet/KismetMathLibrary.h"
+#include "MotionControllerComponent.h"
+
+// Sky sphere properties and functions used by the day-night cycle mechanic
+struct FSkySphereReflection
+{
+	UObjectPropertyBase* DirectionalLightActorProperty = nullptr;
+	UFloatProperty* SunBrightnessProperty = nullptr;
+	UFunction* UpdateSunDirectionFunction = nullptr;
+};
+
+// Looked up once per sky sphere class
+static TMap<TWeakObjectPtr<UClass>, FSkySphereReflection> SkySphereReflectionCache;
+
+static FSkySphereReflection GetSkySphereReflection(UClass* SkySphereClass)
+{
+	if (const FSkySphereReflection* Cached = SkySphereReflectionCache.Find(SkySphereClass))
+	{
+		return *Cached;
+	}
+
+	FSkySphereReflection Reflection;
+	Reflection.DirectionalLightActorProperty = FindField<UObjectPropertyBase>(SkySphereClass, FName("Directional Light Actor"));
+	Reflection.SunBrightnessProperty = FindField<UFloatProperty>(SkySphereClass, FName("Sun Brightness"));
+
+	// Only called without parameters
+	UFunction* UpdateSunDirection = SkySphereClass->FindFunctionByName(FName("UpdateSunDirection"));
+	if (UpdateSunDirection && UpdateSunDirection->NumParms == 0)
+	{
+		Reflection.UpdateSunDirectionFunction = UpdateSunDirection;
+	}
+
+	SkySphereReflectionCache.Add(SkySphereClass, Reflection);
+	return Reflection;
+}
 
 
 // Sets default values for this component's properties
@@ -24,6 +59,145 @@ URunebergVR_Grabber::URunebergVR_Grabber()
 
 }
 
+// Called when the game starts
+void URunebergVR_Grabber::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Set a default grabbable object type if none was specified
+	if (Grabbable_ObjectTypes.Num() < 1)
+	{
+		Grabbable_ObjectTypes.Add(UEngineTypes::ConvertToObjectType(ECollisionChannel::ECC_PhysicsBody));
+	}
+
+	GrabPredictionDelegate.BindUObject(this, &URunebergVR_Grabber::OnGrabPredictionTraceDone);
+	SubstepHoldDelegate.BindUObject(this, &URunebergVR_Grabber::SubstepHeldObject);
+
+	if (bUseGrabVolume)
+	{
+		// Proximity volume that only overlaps grabbable objects, uniquely named as a pawn usually has a grabber per hand
+		GrabVolume = NewObject<USphereComponent>(GetOwner(), MakeUniqueObjectName(GetOwner(), USphereComponent::StaticClass(), TEXT("GrabVolume")));
+		GrabVolume->SetupAttachment(this);
+		GrabVolume->SetSphereRadius(GrabVolumeRadius);
+		GrabVolume->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+		GrabVolume->SetCollisionResponseToAllChannels(ECR_Ignore);
+		for (const TEnumAsByte<EObjectTypeQuery>& ObjectType : Grabbable_ObjectTypes)
+		{
+			GrabVolume->SetCollisionResponseToChannel(UEngineTypes::ConvertToCollisionChannel(ObjectType), ECR_Overlap);
+		}
+		GrabVolume->SetGenerateOverlapEvents(true);
+		GrabVolume->OnComponentBeginOverlap.AddDynamic(this, &URunebergVR_Grabber::OnGrabVolumeBeginOverlap);
+		GrabVolume->OnComponentEndOverlap.AddDynamic(this, &URunebergVR_Grabber::OnGrabVolumeEndOverlap);
+		GrabVolume->RegisterComponent();
+	}
+}
+
+// Called when the game ends
+void URunebergVR_Grabber::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Give objects held by GrabMultiple their gravity back
+	ReleaseMultiple();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+// Keep grabbable actors entering the grab volume
+void URunebergVR_Grabber::OnGrabVolumeBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+{
+	if (!OtherActor || OtherActor == GetOwner())
+	{
+		return;
+	}
+
+	// Actors can overlap with more than one component
+	for (FGrabCandidate& Candidate : GrabCandidates)
+	{
+		if (Candidate.Actor == OtherActor)
+		{
+			Candidate.OverlapCount++;
+			return;
+		}
+	}
+
+	FGrabCandidate Candidate;
+	Candidate.Actor = OtherActor;
+	Candidate.PhysicsHandle = OtherActor->FindComponentByClass<UPhysicsHandleComponent>();
+	Candidate.OverlapCount = 1;
+	GrabCandidates.Add(Candidate);
+}
+
+// Drop grabbable actors leaving the grab volume
+void URunebergVR_Grabber::OnGrabVolumeEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
+{
+	for (int32 i = 0; i < GrabCandidates.Num(); i++)
+	{
+		if (GrabCandidates[i].Actor == OtherActor)
+		{
+			if (--GrabCandidates[i].OverlapCount <= 0)
+			{
+				GrabCandidates.RemoveAtSwap(i);
+			}
+			return;
+		}
+	}
+}
+
+// Closest grab candidate within reach with a physics handle (and tag, if any)
+AActor* URunebergVR_Grabber::GetGrabCandidate(float Reach, FName TagName, bool RetainDistance, UPhysicsHandleComponent*& OutPhysicsHandle)
+{
+	const FVector GrabLocation = GetComponentLocation();
+	AActor* BestActor = nullptr;
+	float BestDistanceSquared = FMath::Square(Reach);
+	OutPhysicsHandle = nullptr;
+
+	for (int32 i = GrabCandidates.Num() - 1; i >= 0; i--)
+	{
+		const FGrabCandidate& Candidate = GrabCandidates[i];
+
+		// Destroyed while overlapping
+		if (!Candidate.Actor.IsValid())
+		{
+			GrabCandidates.RemoveAtSwap(i);
+			continue;
+		}
+
+		UPhysicsHandleComponent* PhysicsHandle = Candidate.PhysicsHandle.Get();
+		if (!PhysicsHandle || (!TagName.IsNone() && !FRunebergVRTags::HasTag(PhysicsHandle, TagName)))
+		{
+			continue;
+		}
+
+		// Distance to the candidate's closest point, which precision grabs hold it at
+		FVector GrabPoint = Candidate.Actor->GetActorLocation();
+		UPrimitiveComponent* RootPrimitive = Cast<UPrimitiveComponent>(Candidate.Actor->GetRootComponent());
+		FVector ClosestPoint;
+		if (RootPrimitive && RootPrimitive->GetClosestPointOnCollision(GrabLocation, ClosestPoint) > 0.f)
+		{
+			GrabPoint = ClosestPoint;
+		}
+
+		const float DistanceSquared = FVector::DistSquared(GrabLocation, GrabPoint);
+		if (DistanceSquared <= BestDistanceSquared)
+		{
+			BestActor = Candidate.Actor.Get();
+			BestDistanceSquared = DistanceSquared;
+			OutPhysicsHandle = PhysicsHandle;
+			NewGrabbedLocation = GrabPoint;
+		}
+	}
+
+	if (BestActor)
+	{
+		// Update Distance with grab distance
+		if (!RetainDistance)
+		{
+			DistanceFromController = FVector::Dist(GrabLocation, NewGrabbedLocation);
+		}
+	}
+
+	return BestActor;
+}
+
 // Called every frame
 void URunebergVR_Grabber::TickComponent( float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction )
 {
@@ -37,6 +211,12 @@ void URunebergVR_Grabber::TickComponent( float DeltaTime, ELevelTick TickType, F
 		ControllerRotation = GetAttachParent()->GetComponentRotation();
 
 		UpdatePullPush();
+
+		// Held objects that the physics handle doesn't move follow the new distance directly
+		if (!bManualAttach && (HoldMode == EGrabHoldMode::KINEMATIC || HoldMode == EGrabHoldMode::LATE_UPDATE || HoldMode == EGrabHoldMode::PHYSICS_SUBSTEP))
+		{
+			UpdateHeldObject();
+		}
 	}
 	// Update grabbed object location & rotation (if any)
 	else if (GrabbedObject && !bManualAttach) {
@@ -45,33 +225,24 @@ void URunebergVR_Grabber::TickComponent( float DeltaTime, ELevelTick TickType, F
 		ControllerLocation = GetAttachParent()->GetComponentLocation();
 		ControllerRotation = GetAttachParent()->GetComponentRotation();
 
-		switch (GrabType)
-		{
-		case EGrabTypeEnum::PRECISION_GRAB:
-		case EGrabTypeEnum::SNAP_GRAB:
-
-			// Add controller rotation offsets
-			ControllerRotation.Add(StandardOffset.Pitch, StandardOffset.Yaw, StandardOffset.Roll);
-			if (RotationOffset != FRotator::ZeroRotator)
-			{
-				ControllerRotation.Add(RotationOffset.Pitch, RotationOffset.Yaw, RotationOffset.Roll);
-			}
-
-			// Set grabbed object rotation
-			GrabbedObject->GetOwner()->SetActorLocation(ControllerLocation + 
-				(ControllerRotation.Vector() * (DistanceFromController + LocationOffset)));
-			GrabbedObject->GetOwner()->SetActorRotation(ControllerRotation);
-			break;
+		UpdateHeldObject();
+	}
 
-		case EGrabTypeEnum::LOCK_GRAB:
-		case EGrabTypeEnum::DANGLING_GRAB:
-		case EGrabTypeEnum::PRECISION_LOCK:
-			GrabbedObject->GetOwner()->SetActorLocation(ControllerLocation + (ControllerRotation.Vector() * DistanceFromController));
-			break;
+	// Objects held by GrabMultiple
+	if (MultiGrabComponents.Num() > 0)
+	{
+		UpdateMultiGrab(DeltaTime);
+	}
 
-		default:
-			break;
-		}
+	// Predict what would be grabbed
+	if (bPredictGrabTarget && !GrabbedObject)
+	{
+		UpdateGrabPrediction();
+	}
+	else if (PredictedGrabActor)
+	{
+		PredictedGrabActor = nullptr;
+		PredictedPhysicsHandle = nullptr;
 	}
 
 	// Day Night cycle
@@ -94,6 +265,7 @@ AActor* URunebergVR_Grabber::Grab(float Reach, bool DoRadialTrace, bool ScanOnly
 	DistanceFromController = Reach;
 	RotationOffset = Rotation_Offset;
 	bManualAttach = ScanOnlyWillManuallyAttach;
+	bHoldTargetValid = false;
 
 	// Update controller location & rotation
 	ControllerLocation = GetAttachParent()->GetComponentLocation();
@@ -140,17 +312,49 @@ AActor* URunebergVR_Grabber::Grab(float Reach, bool DoRadialTrace, bool ScanOnly
 
 	}
 
+	// Grab volume candidates are limited by the full reach, traces split it between length and radius
+	const float VolumeReach = Reach;
+
 	// Calculate Reach
 	Reach = DoRadialTrace ? Reach / 2 : Reach;
 
-	// Line trace
-	AActor* ActorHit = GetHit(DoRadialTrace, Reach, this->GetComponentLocation(), this->GetComponentLocation() + (this->GetComponentRotation().Vector() * Reach), RetainDistance, ShowDebug);
+	AActor* ActorHit = nullptr;
+	UPhysicsHandleComponent* PhysicsHandle = nullptr;
+	if (GrabVolume)
+	{
+		// Pick from the grab volume's candidates
+		ActorHit = GetGrabCandidate(VolumeReach, TagName, RetainDistance, PhysicsHandle);
+	}
+	else if (bPredictGrabTarget && GetWorld()->GetTimeSeconds() - GrabPredictionResultTime <= GrabPredictionMaxAge
+		&& GrabPredictionResultReach == Reach && bGrabPredictionResultRadial == DoRadialTrace)
+	{
+		// Reuse the predictive grab trace
+		if (IsValid(PredictedGrabActor) && PredictedPhysicsHandle.IsValid())
+		{
+			ActorHit = PredictedGrabActor;
+			PhysicsHandle = PredictedPhysicsHandle.Get();
+			NewGrabbedLocation = ActorHit->GetActorTransform().TransformPosition(PredictedGrabLocalLocation);
+			if (!RetainDistance)
+			{
+				DistanceFromController = PredictedGrabDistance;
+			}
+		}
+	}
+	else
+	{
+		// Line trace
+		ActorHit = GetHit(DoRadialTrace, Reach, this->GetComponentLocation(), this->GetComponentLocation() + (this->GetComponentRotation().Vector() * Reach), RetainDistance, ShowDebug);
+		if (ActorHit)
+		{
+			PhysicsHandle = ActorHit->FindComponentByClass<UPhysicsHandleComponent>();
+		}
+	}
 
 	// Check if there's a valid object to grab
 	if (ActorHit)
 	{
 		// Only grab an object with a Physics Handle
-		GrabbedObject = ActorHit->FindComponentByClass<UPhysicsHandleComponent>();
+		GrabbedObject = PhysicsHandle;
 		//UE_LOG(LogTemp, Warning, TEXT("GRABBER - I grabbed : %s"), *ActorHit->GetName());
 
 		// Automatic Attachment - Attach to Physics Handle
@@ -159,7 +363,7 @@ AActor* URunebergVR_Grabber::Grab(float Reach, bool DoRadialTrace, bool ScanOnly
 			// Check for actor tag
 			if (!TagName.IsNone())
 			{
-				if (!GrabbedObject->ComponentHasTag(TagName))
+				if (!FRunebergVRTags::HasTag(GrabbedObject, TagName))
 				{
 					//UE_LOG(LogTemp, Warning, TEXT("GRABBER - Couldn't find %s tag in this physics handle."), *TagName.ToString());
 					return nullptr;
@@ -237,6 +441,32 @@ AActor* URunebergVR_Grabber::Grab(float Reach, bool DoRadialTrace, bool ScanOnly
 					}
 
 				}
+
+				// Kinematic and late updated holds move the object directly, let go of the handle before simulation is turned off under it
+				if ((HoldMode == EGrabHoldMode::KINEMATIC || HoldMode == EGrabHoldMode::LATE_UPDATE) && ComponentToGrab)
+				{
+					GrabbedObject->ReleaseComponent();
+
+					if (ComponentToGrab->IsSimulatingPhysics())
+					{
+						ComponentToGrab->SetSimulatePhysics(false);
+						KinematicHeldComponent = ComponentToGrab;
+					}
+
+					// Children of the motion controller are moved by its late update on the render thread, anywhere else the hold stays kinematic
+					if (HoldMode == EGrabHoldMode::LATE_UPDATE && Cast<UMotionControllerComponent>(GetAttachParent()))
+					{
+						ComponentToGrab->AttachToComponent(GetAttachParent(), FAttachmentTransformRules::KeepWorldTransform);
+						AttachedHeldComponent = ComponentToGrab;
+					}
+				}
+
+				// Substep holds drive the body themselves, the handle's drive would pull it towards the end of frame target
+				if (HoldMode == EGrabHoldMode::PHYSICS_SUBSTEP && ComponentToGrab)
+				{
+					GrabbedObject->ReleaseComponent();
+					SubstepHeldComponent = ComponentToGrab;
+				}
 			}
 
 			// UE_LOG(LogTemp, Warning, TEXT("GRABBER - Returning Actor %s."), *ActorHit->GetName());
@@ -248,6 +478,337 @@ AActor* URunebergVR_Grabber::Grab(float Reach, bool DoRadialTrace, bool ScanOnly
 	return nullptr;
 }
 
+// Grab every simulating object within radius of the grabber
+int32 URunebergVR_Grabber::GrabMultiple(float Radius, FName TagName, bool ShowDebug)
+{
+	// Set a default grabbable object type if none was specified
+	if (Grabbable_ObjectTypes.Num() < 1)
+	{
+		Grabbable_ObjectTypes.Add(UEngineTypes::ConvertToObjectType(ECollisionChannel::ECC_PhysicsBody));
+	}
+
+	if (ShowDebug)
+	{
+		DrawDebugSphere(GetWorld(), GetComponentLocation(), Radius, 8, FColor(255, 0, 0), false, 1.f, 0, 1.f);
+	}
+
+	// One overlap query for everything in reach
+	TArray<FOverlapResult> Overlaps;
+	FCollisionQueryParams QueryParameters(FName(TEXT("GrabMultiple")), false, GetOwner());
+	GetWorld()->OverlapMultiByObjectType(Overlaps, GetComponentLocation(), FQuat::Identity,
+		FCollisionObjectQueryParams(Grabbable_ObjectTypes), FCollisionShape::MakeSphere(Radius), QueryParameters);
+
+	const FTransform& GrabberTransform = GetComponentTransform();
+	int32 NumGrabbed = 0;
+	for (const FOverlapResult& Overlap : Overlaps)
+	{
+		if (MultiGrabComponents.Num() >= MaxMultiGrabObjects)
+		{
+			break;
+		}
+
+		// One entry per component, driving its own body
+		UPrimitiveComponent* Component = Overlap.GetComponent();
+		FBodyInstance* Body = Component ? Component->GetBodyInstance() : nullptr;
+		if (!Body || !Body->IsInstanceSimulatingPhysics() || MultiGrabComponentSet.Contains(Component))
+		{
+			continue;
+		}
+
+		// Check for tag
+		if (!TagName.IsNone() && !FRunebergVRTags::HasTag(Component, TagName) && !FRunebergVRTags::HasTag(Component->GetOwner(), TagName))
+		{
+			continue;
+		}
+
+		MultiGrabComponents.Add(Component);
+		MultiGrabComponentSet.Add(Component);
+		MultiGrabOffsets.Add(Body->GetUnrealWorldTransform().GetRelativeTransform(GrabberTransform));
+		MultiGrabGravity.Add(Body->bEnableGravity);
+
+		// Held up by the grabber
+		Body->SetEnableGravity(false);
+		NumGrabbed++;
+	}
+
+	return NumGrabbed;
+}
+
+// Release all objects held by GrabMultiple
+int32 URunebergVR_Grabber::ReleaseMultiple()
+{
+	const int32 NumReleased = MultiGrabComponents.Num();
+	for (int32 i = NumReleased - 1; i >= 0; i--)
+	{
+		RemoveMultiGrabbed(i);
+	}
+
+	return NumReleased;
+}
+
+// Drop an object held by GrabMultiple
+void URunebergVR_Grabber::RemoveMultiGrabbed(int32 Index)
+{
+	UPrimitiveComponent* Component = MultiGrabComponents[Index].Get();
+	FBodyInstance* Body = Component ? Component->GetBodyInstance() : nullptr;
+	if (Body)
+	{
+		Body->SetEnableGravity(MultiGrabGravity[Index]);
+	}
+
+	MultiGrabComponentSet.Remove(MultiGrabComponents[Index]);
+	MultiGrabComponents.RemoveAtSwap(Index);
+	MultiGrabOffsets.RemoveAtSwap(Index);
+	MultiGrabGravity.RemoveAtSwap(Index);
+}
+
+// Drive all objects held by GrabMultiple towards their hold targets
+void URunebergVR_Grabber::UpdateMultiGrab(float DeltaTime)
+{
+	if (DeltaTime < KINDA_SMALL_NUMBER)
+	{
+		return;
+	}
+
+	const FTransform& GrabberTransform = GetComponentTransform();
+	const float InvDeltaTime = 1.f / DeltaTime;
+	for (int32 i = MultiGrabComponents.Num() - 1; i >= 0; i--)
+	{
+		// Destroyed while held, or its body went away
+		UPrimitiveComponent* Component = MultiGrabComponents[i].Get();
+		FBodyInstance* Body = Component ? Component->GetBodyInstance() : nullptr;
+		if (!Body || !Body->IsValidBodyInstance())
+		{
+			RemoveMultiGrabbed(i);
+			continue;
+		}
+
+		const FTransform Target = MultiGrabOffsets[i] * GrabberTransform;
+		const FTransform Current = Body->GetUnrealWorldTransform();
+
+		// Velocity that reaches the target in one frame
+		FQuat DeltaQuat = Target.GetRotation() * Current.GetRotation().Inverse();
+		if (DeltaQuat.W < 0.f)
+		{
+			DeltaQuat = -DeltaQuat;
+		}
+		FVector Axis;
+		float Angle;
+		DeltaQuat.ToAxisAndAngle(Axis, Angle);
+
+		Body->SetLinearVelocity((Target.GetLocation() - Current.GetLocation()) * InvDeltaTime, false);
+		Body->SetAngularVelocityInRadians(Axis * Angle * InvDeltaTime, false);
+	}
+}
+
+// Where the grabbed object should be this frame
+void URunebergVR_Grabber::GetHoldTarget(FVector& OutLocation, FRotator& OutRotation, bool& bOutSetRotation)
+{
+	switch (GrabType)
+	{
+	case EGrabTypeEnum::PRECISION_GRAB:
+	case EGrabTypeEnum::SNAP_GRAB:
+
+		// Add controller rotation offsets
+		ControllerRotation.Add(StandardOffset.Pitch, StandardOffset.Yaw, StandardOffset.Roll);
+		if (RotationOffset != FRotator::ZeroRotator)
+		{
+			ControllerRotation.Add(RotationOffset.Pitch, RotationOffset.Yaw, RotationOffset.Roll);
+		}
+
+		OutLocation = ControllerLocation + (ControllerRotation.Vector() * (DistanceFromController + LocationOffset));
+		OutRotation = ControllerRotation;
+		bOutSetRotation = true;
+		break;
+
+	default:
+		OutLocation = ControllerLocation + (ControllerRotation.Vector() * DistanceFromController);
+		OutRotation = ControllerRotation;
+		bOutSetRotation = false;
+		break;
+	}
+}
+
+// Move the grabbed object to its hold target
+void URunebergVR_Grabber::UpdateHeldObject()
+{
+	FVector TargetLocation;
+	FRotator TargetRotation;
+	bool bSetRotation;
+	GetHoldTarget(TargetLocation, TargetRotation, bSetRotation);
+
+	AActor* GrabbedActor = GrabbedObject->GetOwner();
+
+	// Late updated holds that couldn't attach to a motion controller are held kinematic
+	EGrabHoldMode ActiveHoldMode = HoldMode;
+	if (ActiveHoldMode == EGrabHoldMode::LATE_UPDATE && !AttachedHeldComponent.IsValid())
+	{
+		ActiveHoldMode = EGrabHoldMode::KINEMATIC;
+	}
+
+	switch (ActiveHoldMode)
+	{
+	case EGrabHoldMode::PHYSICS_HANDLE:
+
+		// Physics moves the object to the handle's target
+		if (bSetRotation)
+		{
+			GrabbedObject->SetTargetLocationAndRotation(TargetLocation, TargetRotation);
+		}
+		else
+		{
+			GrabbedObject->SetTargetLocation(TargetLocation);
+		}
+		break;
+
+	case EGrabHoldMode::KINEMATIC:
+	{
+		// One transform update for the object and its attachments, overlaps are updated once at the end
+		FScopedMovementUpdate ScopedMovement(GrabbedActor->GetRootComponent(), EScopedUpdate::DeferredUpdates);
+		if (bSetRotation)
+		{
+			GrabbedActor->SetActorLocationAndRotation(TargetLocation, TargetRotation, false, nullptr, ETeleportType::TeleportPhysics);
+		}
+		else
+		{
+			GrabbedActor->SetActorLocation(TargetLocation, false, nullptr, ETeleportType::TeleportPhysics);
+		}
+		break;
+	}
+
+	case EGrabHoldMode::LATE_UPDATE:
+	{
+		// Attached to the controller, only moved when its hold target changes relative to the controller
+		USceneComponent* GrabbedRoot = GrabbedActor->GetRootComponent();
+		const FTransform& ControllerTransform = GetAttachParent()->GetComponentTransform();
+		const FVector RelativeLocation = ControllerTransform.InverseTransformPosition(TargetLocation);
+		const FRotator RelativeRotation = bSetRotation ? ControllerTransform.InverseTransformRotation(TargetRotation.Quaternion()).Rotator() : GrabbedRoot->RelativeRotation;
+		if (!RelativeLocation.Equals(GrabbedRoot->RelativeLocation, 0.01f) || !RelativeRotation.Equals(GrabbedRoot->RelativeRotation, 0.01f))
+		{
+			GrabbedRoot->SetRelativeLocationAndRotation(RelativeLocation, RelativeRotation, false, nullptr, ETeleportType::TeleportPhysics);
+		}
+		break;
+	}
+
+	case EGrabHoldMode::PHYSICS_SUBSTEP:
+	{
+		// Substeps interpolate from last frame's target to this one
+		UPrimitiveComponent* GrabbedComponent = SubstepHeldComponent.Get();
+		const FTransform NewHoldTarget(bSetRotation ? TargetRotation : GrabbedActor->GetActorRotation(), TargetLocation);
+		PrevHoldTarget = bHoldTargetValid ? CurrHoldTarget : NewHoldTarget;
+		CurrHoldTarget = NewHoldTarget;
+		bHoldTargetValid = true;
+		bSubstepHoldRotation = bSetRotation;
+		HoldFrameTime = GetWorld()->GetDeltaSeconds();
+		HoldSubstepTime = 0.f;
+
+		// Custom physics has to be added every frame
+		FBodyInstance* Body = GrabbedComponent ? GrabbedComponent->GetBodyInstance() : nullptr;
+		if (Body)
+		{
+			Body->AddCustomPhysics(SubstepHoldDelegate);
+		}
+		break;
+	}
+
+	default:
+
+		// Set grabbed object location & rotation
+		GrabbedActor->SetActorLocation(TargetLocation);
+		if (bSetRotation)
+		{
+			GrabbedActor->SetActorRotation(TargetRotation);
+		}
+		break;
+	}
+}
+
+// Physics substep callback for physics substep holds
+void URunebergVR_Grabber::SubstepHeldObject(float DeltaTime, FBodyInstance* BodyInstance)
+{
+	if (DeltaTime < KINDA_SMALL_NUMBER)
+	{
+		return;
+	}
+
+	// How far into the frame this substep ends
+	HoldSubstepTime += DeltaTime;
+	const float Alpha = HoldFrameTime > KINDA_SMALL_NUMBER ? FMath::Clamp(HoldSubstepTime / HoldFrameTime, 0.f, 1.f) : 1.f;
+	const FTransform Current = BodyInstance->GetUnrealWorldTransform_AssumesLocked();
+
+	// Velocity that reaches the interpolated target at the end of the substep
+	const FVector TargetLocation = FMath::Lerp(PrevHoldTarget.GetLocation(), CurrHoldTarget.GetLocation(), Alpha);
+	BodyInstance->SetLinearVelocity((TargetLocation - Current.GetLocation()) / DeltaTime, false);
+
+	if (bSubstepHoldRotation)
+	{
+		const FQuat TargetQuat = FQuat::Slerp(PrevHoldTarget.GetRotation(), CurrHoldTarget.GetRotation(), Alpha);
+		FQuat DeltaQuat = TargetQuat * Current.GetRotation().Inverse();
+		if (DeltaQuat.W < 0.f)
+		{
+			DeltaQuat = -DeltaQuat;
+		}
+		FVector Axis;
+		float Angle;
+		DeltaQuat.ToAxisAndAngle(Axis, Angle);
+		BodyInstance->SetAngularVelocityInRadians(Axis * Angle / DeltaTime, false);
+	}
+}
+
+// Start the next predictive grab trace
+void URunebergVR_Grabber::UpdateGrabPrediction()
+{
+	const float TimeSeconds = GetWorld()->GetTimeSeconds();
+	if (bGrabPredictionPending || TimeSeconds - GrabPredictionTime < 1.f / FMath::Max(GrabPredictionRate, 1.f))
+	{
+		return;
+	}
+
+	GrabPredictionTime = TimeSeconds;
+	bGrabPredictionPending = true;
+
+	// Same trace as Grab would do
+	const FVector TraceStart = GetComponentLocation();
+	const FCollisionObjectQueryParams ObjectParams(Grabbable_ObjectTypes);
+	const FCollisionQueryParams TraceParameters(FName(TEXT("GrabPrediction")), false, GetOwner());
+	if (bGrabPredictionRadialTrace)
+	{
+		GetWorld()->AsyncSweepByObjectType(EAsyncTraceType::Multi, TraceStart, TraceStart, ObjectParams,
+			FCollisionShape::MakeSphere(GrabPredictionReach / 2), TraceParameters, &GrabPredictionDelegate);
+	}
+	else
+	{
+		GetWorld()->AsyncLineTraceByObjectType(EAsyncTraceType::Single, TraceStart, TraceStart + (GetComponentRotation().Vector() * GrabPredictionReach),
+			ObjectParams, TraceParameters, &GrabPredictionDelegate);
+	}
+}
+
+// Predictive grab trace is done
+void URunebergVR_Grabber::OnGrabPredictionTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	bGrabPredictionPending = false;
+	GrabPredictionResultTime = GrabPredictionTime;
+	GrabPredictionResultReach = bGrabPredictionRadialTrace ? GrabPredictionReach / 2 : GrabPredictionReach;
+	bGrabPredictionResultRadial = bGrabPredictionRadialTrace;
+	PredictedGrabActor = nullptr;
+	PredictedPhysicsHandle = nullptr;
+
+	// Only objects with a physics handle can be grabbed
+	const FHitResult* Hit = TraceDatum.OutHits.Num() > 0 ? &TraceDatum.OutHits[0] : nullptr;
+	AActor* ActorHit = Hit ? Hit->GetActor() : nullptr;
+	UPhysicsHandleComponent* PhysicsHandle = ActorHit ? ActorHit->FindComponentByClass<UPhysicsHandleComponent>() : nullptr;
+	if (PhysicsHandle)
+	{
+		PredictedGrabActor = ActorHit;
+		PredictedPhysicsHandle = PhysicsHandle;
+		PredictedGrabLocation = Hit->ImpactPoint;
+		PredictedGrabDistance = Hit->Distance;
+
+		// Kept relative to the actor, it may move before the grab
+		PredictedGrabLocalLocation = ActorHit->GetActorTransform().InverseTransformPosition(Hit->ImpactPoint);
+	}
+}
+
 // Raycast and get any object hit by the line trace
 AActor* URunebergVR_Grabber::GetHit(bool DoRadialTrace, float Reach, FVector LineTraceStart, FVector LineTraceEnd, bool RetainDistance, bool bShowDebugLine)
 {
@@ -324,6 +885,11 @@ AActor* URunebergVR_Grabber::GetHit(bool DoRadialTrace, float Reach, FVector Lin
 // Release hold of object
 AActor* URunebergVR_Grabber::Release()
 {
+	// Finish the sun's rotation
+	if (bIsGrabbingSun)
+	{
+		ApplySunUpdate();
+	}
 	bIsGrabbingSun = false;
 
 	if (GrabbedObject) 
@@ -344,6 +910,23 @@ AActor* URunebergVR_Grabber::Release()
 			GrabbedObject->ReleaseComponent();
 		}
 
+		// Let go of a late updated hold
+		if (AttachedHeldComponent.IsValid())
+		{
+			AttachedHeldComponent->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+		}
+		AttachedHeldComponent = nullptr;
+
+		// Substep holds stop once the custom physics isn't added anymore
+		SubstepHeldComponent = nullptr;
+
+		// Let go of a kinematic hold, unless the object went away while held
+		if (KinematicHeldComponent.IsValid())
+		{
+			KinematicHeldComponent->SetSimulatePhysics(true);
+		}
+		KinematicHeldComponent = nullptr;
+
 		GrabbedObject = nullptr;
 		return CurrentlyGrabbed;
 	}
@@ -494,7 +1077,10 @@ bool URunebergVR_Grabber::GrabSun(AActor* Sky_Sphere, float SunCycleRate)
 	{
 		// Check if this is a valid Skysphere
 		SkySphere = Sky_Sphere;
-		UObjectPropertyBase* ObjectProp = FindField<UObjectPropertyBase>(Sky_Sphere->GetClass(), FName("Directional Light Actor"));
+		const FSkySphereReflection Reflection = GetSkySphereReflection(Sky_Sphere->GetClass());
+		SunBrightnessProperty = Reflection.SunBrightnessProperty;
+		UpdateSunDirectionFunction = Reflection.UpdateSunDirectionFunction;
+		UObjectPropertyBase* ObjectProp = Reflection.DirectionalLightActorProperty;
 
 		if (ObjectProp) 
 		{
@@ -539,6 +1125,8 @@ bool URunebergVR_Grabber::GrabSun(AActor* Sky_Sphere, float SunCycleRate)
 		// Set global params
 		RotationDuringGrab = GetAttachParent()->RelativeRotation;
 		CycleRate = SunCycleRate;
+		PendingSunPitch = 0.f;
+		LastSunUpdateTime = -1000.f;
 
 		// Calculate the Distance from the Sun Reference Point (in case we are grabbing the sun for the day/night cycle mechanic
 		DistanceFromSun = FVector::Distance(FVector(ControllerLocation.X, 0.f, 0.f), SunReferencePoint);
@@ -632,29 +1220,47 @@ void URunebergVR_Grabber::UpdateDayNight()
 			NewPitch = FMath::Abs(DeltaRotation.Pitch) * CycleRate; // ensure positive delta pitch
 		}
 
-		SunDirectionalLightActor->AddActorLocalRotation(FRotator(NewPitch, 0.f, 0.f));
+		PendingSunPitch += NewPitch;
 
 		// Update day-night cycle mechanic variables
 		DistanceFromSun = CurrentDistanceFromSun;
 		RotationDuringGrab = GetAttachParent()->RelativeRotation;
 
-		// Update the sun's brightness
-		UFloatProperty* FloatProp = FindField<UFloatProperty>(SkySphere->GetClass(), FName("Sun Brightness"));
-		if (FloatProp)
+		// Batch sun rotations - the sun is only updated at the sun update rate and once it has moved enough
+		const float TimeSeconds = GetWorld()->GetTimeSeconds();
+		if (FMath::Abs(PendingSunPitch) >= SunMinAngleDelta && (SunUpdateRate <= 0.f || TimeSeconds - LastSunUpdateTime >= 1.f / SunUpdateRate))
 		{
-			void* ValuePtr = FloatProp->ContainerPtrToValuePtr<void>(SkySphere);
-			if (SunDirectionalLightActor->GetActorRotation().Pitch > HorizonPitch)
-			{
-				FloatProp->SetFloatingPointPropertyValue(ValuePtr, 0.f);
-			}
-			else
-			{
-				FloatProp->SetFloatingPointPropertyValue(ValuePtr, SunBrightness);
-			}
+			LastSunUpdateTime = TimeSeconds;
+			ApplySunUpdate();
 		}
+	}
+}
 
-		// Update the sun direction
-		FOutputDeviceNull ar;
-		SkySphere->CallFunctionByNameWithArguments(TEXT("UpdateSunDirection"), ar, NULL, true);
+// Rotate the sun by the pending pitch and update the sky sphere
+void URunebergVR_Grabber::ApplySunUpdate()
+{
+	if (!SkySphere || !SunDirectionalLightActor || PendingSunPitch == 0.f)
+	{
+		return;
+	}
+
+	SunDirectionalLightActor->AddActorLocalRotation(FRotator(PendingSunPitch, 0.f, 0.f));
+	PendingSunPitch = 0.f;
+
+	// Update the sun's brightness, only when it changes
+	if (SunBrightnessProperty)
+	{
+		const float NewBrightness = SunDirectionalLightActor->GetActorRotation().Pitch > HorizonPitch ? 0.f : SunBrightness;
+		void* ValuePtr = SunBrightnessProperty->ContainerPtrToValuePtr<void>(SkySphere);
+		if (SunBrightnessProperty->GetFloatingPointPropertyValue(ValuePtr) != NewBrightness)
+		{
+			SunBrightnessProperty->SetFloatingPointPropertyValue(ValuePtr, NewBrightness);
+		}
+	}
+
+	// Update the sun direction
+	if (UpdateSunDirectionFunction)
+	{
+		SkySphere->ProcessEvent(UpdateSunDirectionFunction, nullptr);
 	}
 }
\ No newline at end of file
@@ -12,10 +12,26 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 */
 
 #include "RunebergVR_Movement.h"
+#include "RunebergVR_MovementBatcher.h"
+#include "RunebergVRPlugin.h"
 #include "Engine/World.h"
 #include "Components/SceneComponent.h"
 #include "Runtime/NavigationSystem/Public/NavigationSystem.h"
+#include "NavMesh/RecastNavMesh.h"
 #include "IHeadMountedDisplay.h"
+#include "Serialization/BitWriter.h"
+#include "Camera/CameraComponent.h"
+#include "MotionControllerComponent.h"
+#include "Misc/CoreDelegates.h"
+#include "IXRTrackingSystem.h"
+#include "Engine/Engine.h"
+#include "GameFramework/WorldSettings.h"
+
+#if RUNEBERGVR_WITH_OPENVR
+#include "openvr.h"
+#endif
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("VR Movement Net Bytes"), STAT_VRMovementNetBytes, STATGROUP_RunebergVR);
 
 // Sets default values for this component's properties
 URunebergVR_Movement::URunebergVR_Movement()
@@ -33,6 +49,62 @@ void URunebergVR_Movement::BeginPlay()
 
 	// Get reference to the Pawn
 	VRPawn = GetOwner();
+
+	// Capsule for movement sweeps (e.g. the VR pawn's capsule collision)
+	if (VRPawn)
+	{
+		PawnCapsule = VRPawn->FindComponentByClass<UCapsuleComponent>();
+
+		// The HMD and motion controllers are checked against the play area, in the tracking space the camera sits in
+		UCameraComponent* Camera = VRPawn->FindComponentByClass<UCameraComponent>();
+		if (Camera)
+		{
+			TrackingOrigin = Camera->GetAttachParent() ? Camera->GetAttachParent() : VRPawn->GetRootComponent();
+			TrackedComponents.Add(Camera);
+		}
+
+		TArray<UMotionControllerComponent*> MotionControllers;
+		VRPawn->GetComponents<UMotionControllerComponent>(MotionControllers);
+		for (UMotionControllerComponent* MotionController : MotionControllers)
+		{
+			TrackedComponents.Add(MotionController);
+		}
+	}
+
+	// Chaperone play area moves with the recenter, and can be set up again while the headset is off or disconnected
+	HeadsetRecenterHandle = FCoreDelegates::VRHeadsetRecenter.AddUObject(this, &URunebergVR_Movement::OnPlayAreaChanged);
+	HeadsetPutOnHeadHandle = FCoreDelegates::VRHeadsetPutOnHead.AddUObject(this, &URunebergVR_Movement::OnPlayAreaChanged);
+	HeadsetReconnectedHandle = FCoreDelegates::VRHeadsetReconnected.AddUObject(this, &URunebergVR_Movement::OnPlayAreaChanged);
+	TrackingInitializedHandle = FCoreDelegates::VRHeadsetTrackingInitializedDelegate.AddUObject(this, &URunebergVR_Movement::OnPlayAreaChanged);
+
+	// Needed for the move RPCs
+	if (bReplicateVRMovement)
+	{
+		SetIsReplicated(true);
+	}
+	// Batched pawns are moved by the world's movement batcher, which also turns off this component's tick
+	else if (bUseBatchedLocomotion && GetWorld())
+	{
+		FRunebergVRMovementBatcher::Get(GetWorld()).AddComponent(this);
+		bBatched = true;
+	}
+}
+
+// Called when the game ends
+void URunebergVR_Movement::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	FCoreDelegates::VRHeadsetRecenter.Remove(HeadsetRecenterHandle);
+	FCoreDelegates::VRHeadsetPutOnHead.Remove(HeadsetPutOnHeadHandle);
+	FCoreDelegates::VRHeadsetReconnected.Remove(HeadsetReconnectedHandle);
+	FCoreDelegates::VRHeadsetTrackingInitializedDelegate.Remove(TrackingInitializedHandle);
+
+	if (bBatched)
+	{
+		FRunebergVRMovementBatcher::Get(GetWorld()).RemoveComponent(this);
+		bBatched = false;
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 // Called every frame
@@ -40,98 +112,337 @@ void URunebergVR_Movement::TickComponent( float DeltaTime, ELevelTick TickType,
 {
 	Super::TickComponent( DeltaTime, TickType, ThisTickFunction );
 
+	// Bounce back from the play area edge
+	if (VRPawn && bBounceBackFromPlayArea)
+	{
+		CheckPlayAreaBounds();
+	}
+
 	if (VRPawn && (IsMoving || IsBouncingBackFromVRBounds)) {
 
-		// Check if there's a movement reference actor
-		if(CurrentMovementDirectionReference) {
+		UpdateTargetRotation();
 
-			// Set rotation/orientation
-			TargetRotation = FRotator(CurrentMovementDirectionReference->GetComponentTransform().GetRotation());
+		// Move towards the target rotation
+		StepMovement(DeltaTime, TargetRotation, IsBouncingBackFromVRBounds ? BounceBackSpeed : CurrentMovementSpeed, bObeyNavMesh, true);
+	}
+	else if (VRPawn && FixedStepRate > 0.f && GFrameCounter - Last360InputFrame <= 1)
+	{
+		// Full 360 movement input is simulated here when running at a fixed step rate
+		StepMovement(DeltaTime, Input360Rotation, CurrentMovementSpeed, bInput360ObeyNavMesh, false);
+	}
+	else if (VRPawn && !MovementInterpolation.Lag.IsZero())
+	{
+		// Stopped - catch the pawn up with where the simulation ended
+		SetPawnLocation(MovementInterpolation.GetSimLocation(VRPawn->GetActorLocation()));
+		MovementInterpolation.Reset();
+		MovementTimestep.Reset(true);
+	}
 
-			// Apply rotation offset
-			if (OffsetRotation.Equals(FRotator::ZeroRotator))
-			{
-				TargetRotation = FRotator(CurrentMovementDirectionReference->GetComponentTransform().GetRotation());
-			}
-			else 
-			{
-				TargetRotation = FRotator(CurrentMovementDirectionReference->GetComponentTransform().GetRotation()).Add(OffsetRotation.Pitch, OffsetRotation.Yaw, OffsetRotation.Roll);
-			}
+	// Batch predicted moves to the server
+	if (IsPredictingMoves())
+	{
+		SendMoves();
+	}
+}
+
+// Update TargetRotation from the movement reference, offset and axis locks
+void URunebergVR_Movement::UpdateTargetRotation()
+{
+	// Check if there's a movement reference actor
+	if(CurrentMovementDirectionReference) {
 
+		// Set rotation/orientation
+		TargetRotation = FRotator(CurrentMovementDirectionReference->GetComponentTransform().GetRotation());
+
+		// Apply rotation offset
+		if (OffsetRotation.Equals(FRotator::ZeroRotator))
+		{
+			TargetRotation = FRotator(CurrentMovementDirectionReference->GetComponentTransform().GetRotation());
 		}
 		else 
 		{
-			// Apply rotation offset (if any)
-			if (!OffsetRotation.Equals(FRotator::ZeroRotator))
-			{
-				TargetRotation = TargetRotation.Add(OffsetRotation.Pitch, OffsetRotation.Yaw, OffsetRotation.Roll);
-			}
+			TargetRotation = FRotator(CurrentMovementDirectionReference->GetComponentTransform().GetRotation()).Add(OffsetRotation.Pitch, OffsetRotation.Yaw, OffsetRotation.Roll);
 		}
 
-		// Set axis locks : Pitch (Y), Yaw (Z), Roll (X)
-		if (bLockPitchY)
+	}
+	else 
+	{
+		// Apply rotation offset (if any)
+		if (!OffsetRotation.Equals(FRotator::ZeroRotator))
 		{
-			TargetRotation = FRotator(0.f, TargetRotation.Yaw, TargetRotation.Roll);
+			TargetRotation = TargetRotation.Add(OffsetRotation.Pitch, OffsetRotation.Yaw, OffsetRotation.Roll);
 		}
+	}
 
-		if (bLockYawZ)
+	// Set axis locks : Pitch (Y), Yaw (Z), Roll (X)
+	if (bLockPitchY)
+	{
+		TargetRotation = FRotator(0.f, TargetRotation.Yaw, TargetRotation.Roll);
+	}
+
+	if (bLockYawZ)
+	{
+		TargetRotation = FRotator(TargetRotation.Pitch, 0.f, TargetRotation.Roll);
+	}
+
+	if (bLockRollX)
+	{
+		TargetRotation = FRotator(TargetRotation.Pitch, TargetRotation.Yaw, 0.f);
+	}
+}
+
+// Advance the movement simulation and draw the pawn
+void URunebergVR_Movement::StepMovement(float DeltaTime, const FRotator& Direction, float Speed, bool bNavMesh, bool bStopOnNavMeshEdge)
+{
+	// One step per tick unless a fixed step rate is set
+	MovementTimestep.SetRate(FixedStepRate);
+	const int32 Steps = MovementTimestep.Advance(DeltaTime);
+	FVector StepMove = Direction.Vector() * Speed * MovementTimestep.GetStepScale();
+
+	// Networked clients simulate the quantized move so the server gets the same result
+	const bool bPredictMoves = IsPredictingMoves();
+	FVRQuantizedMove NetMove;
+	if (bPredictMoves)
+	{
+		// Within the server's limits and its nav mesh setting, or the server would correct every move
+		bNavMesh = bNetMovesObeyNavMesh;
+		NetMove = FVRQuantizedMove(StepMove.GetClampedToMaxSize(GetMaxNetStepDistance()), bNavMesh);
+		StepMove = NetMove.GetStepMove();
+	}
+
+	FVector SimLocation = MovementInterpolation.GetSimLocation(VRPawn->GetActorLocation());
+	for (int32 Step = 0; Step < Steps; Step++)
+	{
+		const FVector OldLocation = SimLocation;
+		if (!SimulateMove(StepMove, bNavMesh, SimLocation))
 		{
-			TargetRotation = FRotator(TargetRotation.Pitch, 0.f, TargetRotation.Roll);
+			// Stop movement
+			if (bStopOnNavMeshEdge)
+			{
+				DisableVRMovement();
+			}
+			break;
 		}
 
-		if (bLockRollX)
+		MovementInterpolation.AddStep(SimLocation - OldLocation);
+
+		if (bPredictMoves)
 		{
-			TargetRotation = FRotator(TargetRotation.Pitch, TargetRotation.Yaw, 0.f);
+			SaveMove(NetMove, SimLocation);
 		}
+	}
+
+	// Move Pawn to where it is drawn this frame
+	const FVector DrawLocation = MovementInterpolation.GetDrawLocation(SimLocation, MovementTimestep.GetAlpha());
+	if (!DrawLocation.Equals(VRPawn->GetActorLocation()))
+	{
+		SetPawnLocation(DrawLocation);
+	}
+}
 
-		// Set Target Location
-		FVector TargetLocation;
-		if (IsBouncingBackFromVRBounds)
+// Run one movement step from InOutLocation
+bool URunebergVR_Movement::SimulateMove(const FVector& StepMove, bool bNavMesh, FVector& InOutLocation)
+{
+	// Set Target Location
+	FVector TargetLocation = InOutLocation + StepMove;
+
+	// Do we need to move within Nav Mesh Bounds?
+	if (bNavMesh)
+	{
+		// Walk the nav mesh from the pawn's current poly
+		FVector NavTargetLocation;
+		if (!MoveAlongNavMesh(InOutLocation, TargetLocation, NavTargetLocation))
 		{
-			TargetLocation = VRPawn->GetActorLocation() + (TargetRotation.Vector() * BounceBackSpeed);
+			return false;
 		}
-		else
+
+		TargetLocation = NavTargetLocation;
+	}
+
+	InOutLocation = SweepMove(InOutLocation, TargetLocation);
+	return true;
+}
+
+// Whether moves are swept with the pawn capsule
+bool URunebergVR_Movement::CanSweepMovement() const
+{
+	return bSweepMovement && PawnCapsule && PawnCapsule->GetCollisionEnabled() != ECollisionEnabled::NoCollision;
+}
+
+// Put the pawn at Location
+void URunebergVR_Movement::SetPawnLocation(const FVector& Location)
+{
+	if (!CanSweepMovement())
+	{
+		VRPawn->TeleportTo(Location, VRPawn->GetActorRotation());
+		return;
+	}
+
+	// One move for the pawn and everything attached to it, overlaps are updated once at the end
+	FScopedMovementUpdate ScopedMovement(VRPawn->GetRootComponent(), EScopedUpdate::DeferredUpdates);
+	VRPawn->SetActorLocation(Location, false, nullptr, ETeleportType::None);
+}
+
+// How far the pawn can get from From towards TargetLocation
+FVector URunebergVR_Movement::SweepMove(const FVector& From, const FVector& TargetLocation) const
+{
+	if (!CanSweepMovement())
+	{
+		return TargetLocation;
+	}
+
+	// Capsule with its bottom raised by the step height and slightly shrunk so resting contacts don't block the sweep
+	const float Radius = PawnCapsule->GetScaledCapsuleRadius();
+	const float HalfHeight = PawnCapsule->GetScaledCapsuleHalfHeight();
+	const float StepHeight = FMath::Clamp(SweepStepHeight, 0.f, HalfHeight);
+	const float ShrinkAmount = 2.f;
+	const FCollisionShape Shape = FCollisionShape::MakeCapsule(FMath::Max(Radius - ShrinkAmount, 1.f), FMath::Max(HalfHeight - StepHeight * 0.5f - ShrinkAmount, 1.f));
+	const FVector Start = PawnCapsule->GetComponentLocation() + (From - VRPawn->GetActorLocation()) + FVector(0.f, 0.f, StepHeight * 0.5f);
+
+	// Use the capsule's own collision responses
+	FCollisionQueryParams QueryParams(FName(TEXT("VRMovementSweep")), false, VRPawn);
+	FCollisionResponseParams ResponseParams;
+	PawnCapsule->InitSweepCollisionParams(QueryParams, ResponseParams);
+	QueryParams.bFindInitialOverlaps = false;
+
+	// Dashes are swept in capsule sized steps so each slide stays accurate
+	const FVector Delta = TargetLocation - From;
+	int32 NumSteps = 1;
+	if (bIsDashing)
+	{
+		NumSteps = FMath::Clamp(FMath::CeilToInt(Delta.Size() / FMath::Max(Radius, 1.f)), 1, FMath::Max(MaxDashSubsteps, 1));
+	}
+
+	FVector Moved = FVector::ZeroVector;
+	const FVector StepDelta = Delta / NumSteps;
+	for (int32 Step = 0; Step < NumSteps; Step++)
+	{
+		Moved += SweepCapsule(Start + Moved, StepDelta, Shape, QueryParams, ResponseParams);
+	}
+
+	return From + Moved;
+}
+
+// Sweep the capsule by Delta, sliding along blocking hits
+FVector URunebergVR_Movement::SweepCapsule(const FVector& Start, const FVector& Delta, const FCollisionShape& Shape, const FCollisionQueryParams& QueryParams, const FCollisionResponseParams& ResponseParams) const
+{
+	FHitResult Hit;
+	const ECollisionChannel Channel = PawnCapsule->GetCollisionObjectType();
+	if (!GetWorld()->SweepSingleByChannel(Hit, Start, Start + Delta, FQuat::Identity, Channel, Shape, QueryParams, ResponseParams))
+	{
+		return Delta;
+	}
+
+	// Move up to the hit, then slide the rest along the hit surface
+	const FVector ToHit = Hit.Location - Start;
+	const FVector SlideDelta = FVector::VectorPlaneProject(Delta - ToHit, Hit.Normal);
+	if (SlideDelta.IsNearlyZero())
+	{
+		return ToHit;
+	}
+
+	FHitResult SlideHit;
+	const FVector SlideStart = Start + ToHit;
+	if (GetWorld()->SweepSingleByChannel(SlideHit, SlideStart, SlideStart + SlideDelta, FQuat::Identity, Channel, Shape, QueryParams, ResponseParams))
+	{
+		return SlideHit.Location - Start;
+	}
+
+	return ToHit + SlideDelta;
+}
+
+// Advance from the current nav poly towards TargetLocation
+bool URunebergVR_Movement::MoveAlongNavMesh(const FVector& From, const FVector& TargetLocation, FVector& OutLocation)
+{
+	UNavigationSystemV1* NavSystem = Cast<UNavigationSystemV1>(GetWorld()->GetNavigationSystem());
+	if (!NavSystem)
+	{
+		return false;
+	}
+
+#if WITH_RECAST
+	const ARecastNavMesh* NavMesh = Cast<ARecastNavMesh>(NavSystem->GetDefaultNavDataInstance(FNavigationSystem::DontCreate));
+	if (NavMesh)
+	{
+		const FVector PawnLocation = From;
+
+		// Only search the nav mesh if we don't know our poly yet or the pawn was moved by something else (e.g. teleport)
+		if (CurrentNavPoly == INVALID_NAVNODEREF || FVector::DistSquared2D(PawnLocation, CurrentNavLocation) > FMath::Square(FMath::Max(NavMeshTolerance.X, 1.f)))
 		{
-			TargetLocation = VRPawn->GetActorLocation() + (TargetRotation.Vector() * CurrentMovementSpeed);
+			FNavLocation PawnNavLocation;
+			if (!NavSystem->ProjectPointToNavigation(PawnLocation, PawnNavLocation, NavMeshTolerance, NavMesh))
+			{
+				CurrentNavPoly = INVALID_NAVNODEREF;
+				return false;
+			}
+
+			CurrentNavPoly = PawnNavLocation.NodeRef;
+			CurrentNavLocation = PawnNavLocation.Location;
 		}
-		
-		// Do we need to move within Nav Mesh Bounds?
-		if (bObeyNavMesh)
+
+		// Raycast along the nav mesh surface from our poly
+		const FVector RayStart(PawnLocation.X, PawnLocation.Y, CurrentNavLocation.Z);
+		const FVector RayEnd(TargetLocation.X, TargetLocation.Y, CurrentNavLocation.Z + TargetLocation.Z - PawnLocation.Z);
+		FSharedConstNavQueryFilter QueryFilter = NavMesh->GetDefaultQueryFilter();
+		FRaycastResult Result;
+		FVector MoveEnd;
+		ARecastNavMesh::NavMeshRaycast(NavMesh, CurrentNavPoly, RayStart, RayEnd, MoveEnd, QueryFilter, this, Result);
+
+		// Poly is gone (nav mesh rebuilt), search again next frame
+		if (Result.CorridorPolysCount < 1)
 		{
-			// Check TargetLocation if it's in the nav mesh
-			FNavLocation CheckLocation;
-			UNavigationSystemV1* NavSystem = Cast<UNavigationSystemV1>(GetWorld()->GetNavigationSystem());
-			bool bIsWithinNavBounds = false;
+			CurrentNavPoly = INVALID_NAVNODEREF;
+			return false;
+		}
+		NavNodeRef EndPoly = Result.CorridorPolys[Result.CorridorPolysCount - 1];
 
-			if (NavSystem)
+		if (Result.HasHit())
+		{
+			if (!bSlideAlongNavMesh)
 			{
-				bIsWithinNavBounds = NavSystem->ProjectPointToNavigation(
-					TargetLocation,
-					CheckLocation,
-					NavMeshTolerance,
-					(ANavigationData*)0, 0);
+				return false;
 			}
 
-			// Check if target location is within the nav mesh
-			if (bIsWithinNavBounds)
-			{
+			// Drop the part of the move that goes into the edge and carry on along it, starting just short of the edge
+			const FVector MoveDirection = (RayEnd - RayStart).GetSafeNormal2D();
+			const FVector EdgeNormal = FVector(Result.HitNormal.X, Result.HitNormal.Y, 0.f).GetSafeNormal();
+			const FVector SlideStart = MoveEnd - MoveDirection;
+			const FVector Remaining = RayEnd - MoveEnd;
+			const FVector SlideEnd = SlideStart + Remaining - EdgeNormal * FVector::DotProduct(Remaining, EdgeNormal);
 
-				// Move Pawn to Target Location
-				VRPawn->TeleportTo(TargetLocation, VRPawn->GetActorRotation());
-				
+			FRaycastResult SlideResult;
+			ARecastNavMesh::NavMeshRaycast(NavMesh, EndPoly, SlideStart, SlideEnd, MoveEnd, QueryFilter, this, SlideResult);
+			if (SlideResult.CorridorPolysCount > 0)
+			{
+				EndPoly = SlideResult.CorridorPolys[SlideResult.CorridorPolysCount - 1];
 			}
 			else
 			{
-				// Stop movement
-				DisableVRMovement();
+				MoveEnd = SlideStart;
 			}
 		}
-		else 
+
+		// Stuck in a corner
+		if (FVector::DistSquared2D(RayStart, MoveEnd) < KINDA_SMALL_NUMBER)
 		{
-			// Move Pawn to Target Location
-			VRPawn->TeleportTo(TargetLocation, VRPawn->GetActorRotation());
+			return false;
 		}
+
+		CurrentNavPoly = EndPoly;
+		CurrentNavLocation = MoveEnd;
+		OutLocation = FVector(MoveEnd.X, MoveEnd.Y, PawnLocation.Z + MoveEnd.Z - RayStart.Z);
+		return true;
 	}
+#endif
+
+	// Not a recast nav mesh, check if the target location is on the nav mesh
+	FNavLocation CheckLocation;
+	OutLocation = TargetLocation;
+	return NavSystem->ProjectPointToNavigation(
+		TargetLocation,
+		CheckLocation,
+		NavMeshTolerance,
+		(ANavigationData*)0, 0);
 }
 
 // Move VR Pawn
@@ -182,6 +493,7 @@ void URunebergVR_Movement::DisableVRMovement()
 {
 	// Set the Pawn to static state
 	IsMoving = false;
+	bIsDashing = false;
 
 	// Reset Offset
 	OffsetRotation = FRotator::ZeroRotator;
@@ -235,6 +547,7 @@ void URunebergVR_Movement::TimedDashMove(float MovementDuration, float MovementS
 {
 	// Start movement
 	EnableVRMovement(MovementSpeed, nullptr, ObeyNavMesh, false, false, false, MovementDirection);
+	bIsDashing = true;
 
 	// End movement via timer
 	FTimerHandle UnusedHandle;
@@ -264,6 +577,150 @@ void  URunebergVR_Movement::BounceBackFromVRBounds(float MovementSpeed, float Mo
 	GetWorld()->GetTimerManager().SetTimer(UnusedHandle, this, &URunebergVR_Movement::DisableVRBounceBack, MovementDuration, false);
 }
 
+// Use a fixed play area polygon instead of the chaperone's
+void URunebergVR_Movement::SetPlayAreaPolygon(const TArray<FVector2D>& Points)
+{
+	bPlayAreaOverridden = Points.Num() > 0;
+	bPlayAreaDirty = !bPlayAreaOverridden;
+	BuildPlayAreaEdges(Points);
+}
+
+// Chaperone play area corners as a tracking space polygon
+TArray<FVector2D> URunebergVR_Movement::ChaperoneToPlayAreaPolygon(const TArray<FVector>& Corners, float WorldToMeters)
+{
+	// OpenVR is in meters, right handed and Y up
+	TArray<FVector2D> Points;
+	Points.Reserve(Corners.Num());
+	for (const FVector& Corner : Corners)
+	{
+		Points.Add(FVector2D(-Corner.Z, Corner.X) * WorldToMeters);
+	}
+
+	return Points;
+}
+
+// Play area may have moved or been set up again
+void URunebergVR_Movement::OnPlayAreaChanged()
+{
+	bPlayAreaDirty = true;
+}
+
+// Read the play area from the chaperone
+void URunebergVR_Movement::RefreshPlayArea()
+{
+	bPlayAreaDirty = false;
+
+	if (bPlayAreaOverridden)
+	{
+		return;
+	}
+
+	TArray<FVector2D> Points;
+
+#if RUNEBERGVR_WITH_OPENVR
+	// The OpenVR runtime is only loaded when running on SteamVR
+	static const FName SteamVRSystemName(TEXT("SteamVR"));
+	if (GEngine && GEngine->XRSystem.IsValid() && GEngine->XRSystem->GetSystemName() == SteamVRSystemName && vr::VRChaperone())
+	{
+		vr::HmdQuad_t PlayAreaRect;
+		if (vr::VRChaperone()->GetPlayAreaRect(&PlayAreaRect))
+		{
+			TArray<FVector> Corners;
+			for (const vr::HmdVector3_t& Corner : PlayAreaRect.vCorners)
+			{
+				Corners.Add(FVector(Corner.v[0], Corner.v[1], Corner.v[2]));
+			}
+			Points = ChaperoneToPlayAreaPolygon(Corners, GetWorld()->GetWorldSettings()->WorldToMeters);
+		}
+	}
+#endif
+
+	BuildPlayAreaEdges(Points);
+}
+
+// Precompute the play area edges of a polygon
+void URunebergVR_Movement::BuildPlayAreaEdges(const TArray<FVector2D>& Points)
+{
+	PlayAreaEdges.Reset();
+	if (Points.Num() < 3)
+	{
+		return;
+	}
+
+	for (int32 i = 0; i < Points.Num(); i++)
+	{
+		FPlayAreaEdge Edge;
+		Edge.Start = Points[i];
+		Edge.Direction = Points[(i + 1) % Points.Num()] - Points[i];
+		const float LengthSquared = Edge.Direction.SizeSquared();
+		Edge.InvLengthSquared = LengthSquared > KINDA_SMALL_NUMBER ? 1.f / LengthSquared : 0.f;
+		PlayAreaEdges.Add(Edge);
+	}
+}
+
+// Signed distance of a tracking space point to the play area edge
+float URunebergVR_Movement::GetDistanceToPlayAreaEdge(const FVector2D& Point) const
+{
+	float MinDistanceSquared = BIG_NUMBER;
+	bool bInside = false;
+
+	for (const FPlayAreaEdge& Edge : PlayAreaEdges)
+	{
+		// Closest point on the edge
+		const FVector2D ToPoint = Point - Edge.Start;
+		const float Alpha = FMath::Clamp((ToPoint | Edge.Direction) * Edge.InvLengthSquared, 0.f, 1.f);
+		MinDistanceSquared = FMath::Min(MinDistanceSquared, (ToPoint - Edge.Direction * Alpha).SizeSquared());
+
+		// Crossing test for inside / outside
+		const FVector2D End = Edge.Start + Edge.Direction;
+		if ((Edge.Start.Y > Point.Y) != (End.Y > Point.Y) && Point.X < Edge.Start.X + (Point.Y - Edge.Start.Y) * Edge.Direction.X / Edge.Direction.Y)
+		{
+			bInside = !bInside;
+		}
+	}
+
+	const float Distance = FMath::Sqrt(MinDistanceSquared);
+	return bInside ? Distance : -Distance;
+}
+
+// Bounce back if a tracked component just got too close to the play area edge
+void URunebergVR_Movement::CheckPlayAreaBounds()
+{
+	// Only read again when the headset tells us it may have changed
+	if (bPlayAreaDirty)
+	{
+		RefreshPlayArea();
+	}
+
+	if (PlayAreaEdges.Num() < 3 || !TrackingOrigin.IsValid())
+	{
+		DistanceToPlayAreaEdge = 0.f;
+		bNearPlayAreaEdge = false;
+		return;
+	}
+
+	// Closest tracked component, in tracking space
+	const FTransform& OriginTransform = TrackingOrigin->GetComponentTransform();
+	float Distance = BIG_NUMBER;
+	for (const TWeakObjectPtr<USceneComponent>& Tracked : TrackedComponents)
+	{
+		if (Tracked.IsValid())
+		{
+			const FVector TrackedLocation = OriginTransform.InverseTransformPosition(Tracked->GetComponentLocation());
+			Distance = FMath::Min(Distance, GetDistanceToPlayAreaEdge(FVector2D(TrackedLocation)));
+		}
+	}
+	DistanceToPlayAreaEdge = Distance;
+
+	// Only bounce when crossing into the warning distance, so the player can still move away from the edge
+	const bool bNear = Distance < PlayAreaWarningDistance;
+	if (bNear && !bNearPlayAreaEdge && IsMoving && !IsBouncingBackFromVRBounds)
+	{
+		BounceBackFromVRBounds(PlayAreaBounceSpeed, PlayAreaBounceDuration, false);
+	}
+	bNearPlayAreaEdge = bNear;
+}
+
 // Full 360 Movement
 void URunebergVR_Movement::Enable360Movement(USceneComponent* MovementDirectionReference, bool ObeyNavMesh, bool LockPitch, bool LockYaw, bool LockRoll, float MovementSpeed, float XAxisInput, float YAxisInput)
 {
@@ -306,50 +763,327 @@ void URunebergVR_Movement::Enable360Movement(USceneComponent* MovementDirectionR
 		}
 
 
-		// Move Pawn
-		FVector TargetLocation = VRPawn->GetActorLocation() + (TargetRotation.Vector() * CurrentMovementSpeed);
+		// At a fixed step rate the input is simulated on tick, otherwise move straight away
+		if (FixedStepRate > 0.f)
+		{
+			Input360Rotation = TargetRotation;
+			bInput360ObeyNavMesh = ObeyNavMesh;
+			Last360InputFrame = GFrameCounter;
+		}
+		else
+		{
+			StepMovement(GetWorld()->GetDeltaSeconds(), TargetRotation, CurrentMovementSpeed, ObeyNavMesh, false);
+		}
 
-		// Check if we need to obey nav mesh
-		if (ObeyNavMesh)
+	}
+	else
+	{
+		if (!IsMoving && !IsBouncingBackFromVRBounds)
 		{
-			// Check TargetLocation if it's in the nav mesh
-			FNavLocation CheckLocation;
-			UNavigationSystemV1* NavSystem = Cast<UNavigationSystemV1>(GetWorld()->GetNavigationSystem());
-			bool bIsWithinNavBounds = false;
+			// Stop movement if doing full 360 and no x,y axis input is registered (e.g. thumbstick)
+			DisableVRMovement();
+		}
+	}
 
-			if (NavSystem)
-			{
-				bIsWithinNavBounds = NavSystem->ProjectPointToNavigation(
-					TargetLocation,
-					CheckLocation,
-					NavMeshTolerance,
-					(ANavigationData*)0, 0);
-			}
+}
 
-			// Check if target location is within the nav mesh
-			if (bIsWithinNavBounds)
-			{
+// Quantize a movement step
+FVRQuantizedMove::FVRQuantizedMove(const FVector& StepMove, bool bObeyNavMesh)
+{
+	const FRotator Direction = StepMove.Rotation();
+	Yaw = FRotator::CompressAxisToShort(Direction.Yaw);
+	Pitch = FRotator::CompressAxisToShort(Direction.Pitch);
+	Speed = (uint16)FMath::Clamp(FMath::RoundToInt(StepMove.Size() * 10.f), 0, (int32)MAX_uint16);
+	Flags = bObeyNavMesh ? FLAG_ObeyNavMesh : 0;
+}
 
-				// Move Pawn to Target Location
-				VRPawn->TeleportTo(TargetLocation, VRPawn->GetActorRotation());
+// Movement of a single step
+FVector FVRQuantizedMove::GetStepMove() const
+{
+	return FRotator(FRotator::DecompressAxisFromShort(Pitch), FRotator::DecompressAxisFromShort(Yaw), 0.f).Vector() * (Speed * 0.1f);
+}
 
-			}
+// Sequence and move count packed, then 8 bytes per move
+bool FVRMoveBatch::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+{
+	Ar.SerializeIntPacked(Sequence);
 
+	uint32 NumMoves = Moves.Num();
+	Ar.SerializeIntPacked(NumMoves);
+	if (Ar.IsLoading())
+	{
+		if (NumMoves > (uint32)MaxMoves)
+		{
+			Ar.SetError();
+			bOutSuccess = false;
+			return false;
 		}
-		else
+		Moves.SetNum(NumMoves);
+	}
+
+	for (FVRQuantizedMove& Move : Moves)
+	{
+		Ar << Move.Yaw << Move.Pitch << Move.Speed << Move.Steps << Move.Flags;
+	}
+
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
+
+// Whether this is the owning client of a replicated VR movement
+bool URunebergVR_Movement::IsPredictingMoves() const
+{
+	return bReplicateVRMovement && GetOwnerRole() == ROLE_AutonomousProxy;
+}
+
+// Keep a predicted move for the server
+void URunebergVR_Movement::SaveMove(const FVRQuantizedMove& Move, const FVector& EndLocation)
+{
+	// Extend the last move if it hasn't gone out yet
+	if (PendingMoves.Num() > NumSentMoves)
+	{
+		FVRPendingMove& LastMove = PendingMoves.Last();
+		if (LastMove.Move.IsSameInput(Move) && LastMove.Move.Steps < MAX_uint8)
 		{
-			// Move Pawn to Target Location
-			VRPawn->TeleportTo(TargetLocation, VRPawn->GetActorRotation());
+			LastMove.Move.Steps++;
+			LastMove.EndLocation = EndLocation;
+			return;
 		}
+	}
 
+	// Server isn't acknowledging - drop the oldest, a correction will bring us back in line
+	if (PendingMoves.Num() >= FVRMoveBatch::MaxMoves)
+	{
+		PendingMoves.RemoveAt(0, 1, false);
+		NumSentMoves = FMath::Max(NumSentMoves - 1, 0);
 	}
-	else
+
+	FVRPendingMove PendingMove;
+	PendingMove.Move = Move;
+	PendingMove.Sequence = NextMoveSequence++;
+	PendingMove.EndLocation = EndLocation;
+	PendingMoves.Add(PendingMove);
+}
+
+// Send unacknowledged moves to the server
+void URunebergVR_Movement::SendMoves()
+{
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+
+	// Bandwidth over the last second
+	if (CurrentTime - NetBytesWindowStart >= 1.f)
 	{
-		if (!IsMoving && !IsBouncingBackFromVRBounds)
+		NetBytesPerSecond = NetBytesInWindow;
+		NetBytesInWindow = 0;
+		NetBytesWindowStart = CurrentTime;
+	}
+
+	if (PendingMoves.Num() == 0 || CurrentTime - LastMoveSendTime < MoveSendInterval)
+	{
+		return;
+	}
+	LastMoveSendTime = CurrentTime;
+
+	// Every unacknowledged move goes out again, so a lost batch is covered by the next one
+	FVRMoveBatch Batch;
+	Batch.Sequence = PendingMoves[0].Sequence;
+	Batch.Moves.Reserve(PendingMoves.Num());
+	for (const FVRPendingMove& PendingMove : PendingMoves)
+	{
+		Batch.Moves.Add(PendingMove.Move);
+	}
+	NumSentMoves = PendingMoves.Num();
+
+	// Payload size for the bandwidth stat
+	FBitWriter SizeWriter(0, true);
+	bool bSerialized = false;
+	Batch.NetSerialize(SizeWriter, nullptr, bSerialized);
+	NetBytesInWindow += SizeWriter.GetNumBytes();
+	INC_DWORD_STAT_BY(STAT_VRMovementNetBytes, SizeWriter.GetNumBytes());
+
+	ServerMoveBatch(Batch);
+}
+
+// Longest single step the server accepts
+float URunebergVR_Movement::GetMaxNetStepDistance() const
+{
+	return MaxNetMovementSpeed * (FixedStepRate > 0.f ? FVRFixedTimestep::ReferenceRate / FixedStepRate : 1.f);
+}
+
+// Seconds of client time one step stands for
+float URunebergVR_Movement::GetNetStepTime() const
+{
+	return 1.f / FMath::Max(FixedStepRate > 0.f ? FixedStepRate : MaxNetStepRate, 1.f);
+}
+
+// Server time client moves have used up to - idle time only banks up to the tolerance
+float URunebergVR_Movement::GetServerMoveClock() const
+{
+	return FMath::Max(ServerMoveClock, GetWorld()->GetTimeSeconds() - NetMoveTimeTolerance);
+}
+
+// Only malformed batches are rejected, moves that are too fast or too many are trimmed and corrected
+bool URunebergVR_Movement::ServerMoveBatch_Validate(const FVRMoveBatch& Batch)
+{
+	return Batch.Moves.Num() <= FVRMoveBatch::MaxMoves;
+}
+
+// Client moves for the server to simulate
+void URunebergVR_Movement::ServerMoveBatch_Implementation(const FVRMoveBatch& Batch)
+{
+	if (!VRPawn)
+	{
+		return;
+	}
+
+	// Steps the client can still spend before it runs further ahead of the server's clock than the tolerance
+	const float StepTime = GetNetStepTime();
+	float MoveClock = GetServerMoveClock();
+	int32 StepBudget = FMath::Max(FMath::FloorToInt((GetWorld()->GetTimeSeconds() + NetMoveTimeTolerance - MoveClock) / StepTime), 0);
+
+	// Only run moves we haven't seen, batches overlap and can arrive out of order. Speed and nav mesh come from the server's settings,
+	// over speed moves are clamped and steps over the budget dropped - the ack then corrects the client
+	const float MaxStepDistance = GetMaxNetStepDistance();
+	FVector Location = VRPawn->GetActorLocation();
+	for (int32 i = 0; i < Batch.Moves.Num(); i++)
+	{
+		const uint32 Sequence = Batch.Sequence + i;
+		if (Sequence <= LastServerMoveSequence)
 		{
-			// Stop movement if doing full 360 and no x,y axis input is registered (e.g. thumbstick)
-			DisableVRMovement();
+			continue;
+		}
+
+		const FVRQuantizedMove& Move = Batch.Moves[i];
+		const FVector StepMove = Move.GetStepMove().GetClampedToMaxSize(MaxStepDistance);
+		const int32 Steps = FMath::Min<int32>(Move.Steps, StepBudget);
+		StepBudget -= Steps;
+		MoveClock += Steps * StepTime;
+		for (int32 Step = 0; Step < Steps; Step++)
+		{
+			if (!SimulateMove(StepMove, bNetMovesObeyNavMesh, Location))
+			{
+				break;
+			}
+		}
+
+		LastServerMoveSequence = Sequence;
+	}
+	ServerMoveClock = MoveClock;
+
+	if (!Location.Equals(VRPawn->GetActorLocation()))
+	{
+		SetPawnLocation(Location);
+	}
+
+	ClientAckMoves(LastServerMoveSequence, VRPawn->GetActorLocation());
+}
+
+// Server result of the client's moves up to Sequence
+void URunebergVR_Movement::ClientAckMoves_Implementation(uint32 Sequence, FVector_NetQuantize100 ServerLocation)
+{
+	// Find what we predicted for this move and drop everything up to it
+	int32 AckedIndex = INDEX_NONE;
+	for (int32 i = 0; i < PendingMoves.Num() && PendingMoves[i].Sequence <= Sequence; i++)
+	{
+		AckedIndex = i;
+	}
+
+	if (AckedIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	const FVector PredictedLocation = PendingMoves[AckedIndex].EndLocation;
+	PendingMoves.RemoveAt(0, AckedIndex + 1, false);
+	NumSentMoves = FMath::Max(NumSentMoves - (AckedIndex + 1), 0);
+
+	if (FVector::Dist(PredictedLocation, ServerLocation) <= NetCorrectionTolerance)
+	{
+		return;
+	}
+
+	// Mispredicted - start from the server's location and replay the moves it hasn't seen yet
+	FVector Location = ServerLocation;
+	for (FVRPendingMove& PendingMove : PendingMoves)
+	{
+		const FVector StepMove = PendingMove.Move.GetStepMove();
+		for (int32 Step = 0; Step < PendingMove.Move.Steps; Step++)
+		{
+			if (!SimulateMove(StepMove, (PendingMove.Move.Flags & FVRQuantizedMove::FLAG_ObeyNavMesh) != 0, Location))
+			{
+				break;
+			}
 		}
+		PendingMove.EndLocation = Location;
 	}
 
-}
\ No newline at end of file
+	// Shift the pawn by the correction, keeping the drawn interpolation lag
+	const FVector SimLocation = MovementInterpolation.GetSimLocation(VRPawn->GetActorLocation());
+	SetPawnLocation(VRPawn->GetActorLocation() + (Location - SimLocation));
+}
+
+// The pawn was moved outright - moves in flight were made from the old location
+void URunebergVR_Movement::NotifyPawnTeleported()
+{
+	if (!VRPawn || !IsPredictingMoves())
+	{
+		return;
+	}
+
+	PendingMoves.Reset();
+	NumSentMoves = 0;
+	MovementInterpolation.Reset();
+
+	ServerTeleport(NextMoveSequence - 1, VRPawn->GetActorLocation());
+}
+
+bool URunebergVR_Movement::ServerTeleport_Validate(uint32 Sequence, FVector_NetQuantize100 Location)
+{
+	return !Location.ContainsNaN();
+}
+
+// Client teleported its pawn after its moves up to Sequence
+void URunebergVR_Movement::ServerTeleport_Implementation(uint32 Sequence, FVector_NetQuantize100 Location)
+{
+	if (!VRPawn)
+	{
+		return;
+	}
+
+	// Moves from before the teleport that haven't arrived yet are dropped
+	LastServerMoveSequence = FMath::Max(LastServerMoveSequence, Sequence);
+
+	// Too far, or off the nav mesh when net moves have to stay on it - leave the pawn where it is and put the client back
+	bool bAccept = MaxNetTeleportDistance <= 0.f || FVector::Dist(VRPawn->GetActorLocation(), Location) <= MaxNetTeleportDistance;
+	if (bAccept && bNetMovesObeyNavMesh)
+	{
+		UNavigationSystemV1* NavSystem = Cast<UNavigationSystemV1>(GetWorld()->GetNavigationSystem());
+		FNavLocation NavLocation;
+		bAccept = NavSystem && NavSystem->ProjectPointToNavigation(Location, NavLocation, NavMeshTolerance);
+	}
+
+	if (!bAccept)
+	{
+		ClientRejectTeleport(VRPawn->GetActorLocation());
+		return;
+	}
+
+	VRPawn->SetActorLocation(Location, false, nullptr, ETeleportType::TeleportPhysics);
+}
+
+// Server didn't accept the client's teleport
+void URunebergVR_Movement::ClientRejectTeleport_Implementation(FVector_NetQuantize100 ServerLocation)
+{
+	if (!VRPawn)
+	{
+		return;
+	}
+
+	// Moves predicted since the teleport started from the rejected location
+	PendingMoves.Reset();
+	NumSentMoves = 0;
+	MovementInterpolation.Reset();
+	CurrentNavPoly = INVALID_NAVNODEREF;
+
+	VRPawn->SetActorLocation(ServerLocation, false, nullptr, ETeleportType::TeleportPhysics);
+}
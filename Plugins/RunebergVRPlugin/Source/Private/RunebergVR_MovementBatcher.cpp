@@ -0,0 +1,176 @@
+// Copyright (C) 2017 Runeberg (github: 1runeberg, UE4 Forums: runeberg)
+
+/*
+The MIT License (MIT)
+Copyright (c) 2017 runeberg (github: 1runeberg, UE4 Forums: runeberg)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "RunebergVR_MovementBatcher.h"
+#include "RunebergVRPlugin.h"
+#include "RunebergVR_Movement.h"
+#include "Engine/World.h"
+#include "Engine/Level.h"
+#include "Runtime/NavigationSystem/Public/NavigationSystem.h"
+
+DECLARE_CYCLE_STAT(TEXT("VR Movement Batch"), STAT_VRMovementBatch, STATGROUP_RunebergVR);
+DECLARE_DWORD_COUNTER_STAT(TEXT("VR Movement Batched Pawns"), STAT_VRMovementBatchedPawns, STATGROUP_RunebergVR);
+
+// Movement batchers of all live worlds
+static TMap<TWeakObjectPtr<UWorld>, TSharedPtr<FRunebergVRMovementBatcher>> MovementBatchers;
+
+void FRunebergVRMovementBatchTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Batcher && TickType != LEVELTICK_ViewportsOnly)
+	{
+		Batcher->Tick(DeltaTime);
+	}
+}
+
+FString FRunebergVRMovementBatchTickFunction::DiagnosticMessage()
+{
+	return TEXT("FRunebergVRMovementBatchTickFunction");
+}
+
+FRunebergVRMovementBatcher::FRunebergVRMovementBatcher(UWorld* InWorld)
+	: World(InWorld)
+{
+	// Move pawns before physics, same as the component ticks it replaces
+	TickFunction.bCanEverTick = true;
+	TickFunction.bStartWithTickEnabled = false;
+	TickFunction.TickGroup = TG_PrePhysics;
+	TickFunction.Batcher = this;
+	TickFunction.RegisterTickFunction(World->PersistentLevel);
+}
+
+FRunebergVRMovementBatcher::~FRunebergVRMovementBatcher()
+{
+	if (TickFunction.IsTickFunctionRegistered())
+	{
+		TickFunction.UnRegisterTickFunction();
+	}
+}
+
+// Get the movement batcher for a world, creating it if needed
+FRunebergVRMovementBatcher& FRunebergVRMovementBatcher::Get(UWorld* World)
+{
+	TSharedPtr<FRunebergVRMovementBatcher>& Batcher = MovementBatchers.FindOrAdd(World);
+	if (!Batcher.IsValid())
+	{
+		Batcher = MakeShareable(new FRunebergVRMovementBatcher(World));
+	}
+
+	return *Batcher;
+}
+
+// Drop the movement batcher of a world that is being cleaned up
+void FRunebergVRMovementBatcher::OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+	MovementBatchers.Remove(World);
+}
+
+// Add a movement component
+void FRunebergVRMovementBatcher::AddComponent(URunebergVR_Movement* Component)
+{
+	Components.AddUnique(Component);
+	Component->SetComponentTickEnabled(false);
+	TickFunction.SetTickFunctionEnable(true);
+}
+
+// Remove a movement component
+void FRunebergVRMovementBatcher::RemoveComponent(URunebergVR_Movement* Component)
+{
+	Components.RemoveSwap(Component);
+	TickFunction.SetTickFunctionEnable(Components.Num() > 0);
+}
+
+// Move every active component
+void FRunebergVRMovementBatcher::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_VRMovementBatch);
+
+	// Gather the moving pawns and their targets
+	ActiveComponents.Reset();
+	Targets.Reset();
+	for (URunebergVR_Movement* Component : Components)
+	{
+		if (!Component->VRPawn)
+		{
+			continue;
+		}
+
+		// Bounce back from the play area edge, same as the component tick
+		if (Component->bBounceBackFromPlayArea)
+		{
+			Component->CheckPlayAreaBounds();
+		}
+
+		if (!(Component->IsMoving || Component->IsBouncingBackFromVRBounds))
+		{
+			continue;
+		}
+
+		Component->UpdateTargetRotation();
+
+		// Keep the per frame feel of the speed at the reference rate when a fixed step rate is set
+		const float Speed = Component->IsBouncingBackFromVRBounds ? Component->BounceBackSpeed : Component->CurrentMovementSpeed;
+		const float StepScale = Component->FixedStepRate > 0.f ? DeltaTime * FVRFixedTimestep::ReferenceRate : 1.f;
+
+		ActiveComponents.Add(Component);
+		Targets.Add(Component->VRPawn->GetActorLocation() + Component->TargetRotation.Vector() * Speed * StepScale);
+	}
+
+	const int32 NumMoves = ActiveComponents.Num();
+	SET_DWORD_STAT(STAT_VRMovementBatchedPawns, NumMoves);
+	if (NumMoves == 0)
+	{
+		return;
+	}
+
+	// Check every nav constrained target in one batch
+	TArray<FNavigationProjectionWork> Workload;
+	TArray<int32> WorkIndices;
+	for (int32 Index = 0; Index < NumMoves; Index++)
+	{
+		if (ActiveComponents[Index]->bObeyNavMesh)
+		{
+			const FVector Tolerance = ActiveComponents[Index]->NavMeshTolerance;
+			Workload.Add(FNavigationProjectionWork(Targets[Index], FBox(Targets[Index] - Tolerance, Targets[Index] + Tolerance)));
+			WorkIndices.Add(Index);
+		}
+	}
+
+	bCanMove.Init(true, NumMoves);
+	if (Workload.Num() > 0)
+	{
+		UNavigationSystemV1* NavSystem = Cast<UNavigationSystemV1>(World->GetNavigationSystem());
+		if (NavSystem)
+		{
+			NavSystem->BatchProjectPoints(Workload);
+		}
+
+		for (int32 Work = 0; Work < Workload.Num(); Work++)
+		{
+			bCanMove[WorkIndices[Work]] = NavSystem && Workload[Work].bResult;
+		}
+	}
+
+	// Move the pawns
+	for (int32 Index = 0; Index < NumMoves; Index++)
+	{
+		URunebergVR_Movement* Component = ActiveComponents[Index];
+		if (!bCanMove[Index])
+		{
+			// Stop movement
+			Component->DisableVRMovement();
+			continue;
+		}
+
+		Component->VRPawn->SetActorLocation(Targets[Index], false, nullptr, ETeleportType::TeleportPhysics);
+	}
+}
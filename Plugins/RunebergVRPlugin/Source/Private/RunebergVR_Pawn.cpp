@@ -105,46 +105,80 @@ void ARunebergVR_Pawn::Tick(float DeltaTime)
 	// Apply gravity if enabled and camera is positioned at the head of the player
 	if (EnableGravity && Camera->IsValidLowLevel() && CameraPosition.Z > this->GetActorLocation().Z)
 	{
-		// Set line trace for gravity variables
-		FHitResult RayHit(EForceInit::ForceInit);
-		FCollisionQueryParams RayTraceParams(FName(TEXT("GravityRayTrace")), true, this->GetOwner());
-
-		// Initialize Gravity Trace Hit Result var
-		RayTraceParams.bTraceComplex = true;
-		RayTraceParams.bTraceAsyncScene = true;
-		RayTraceParams.bReturnPhysicalMaterial = false;
-		
-		// Do a line trace and check for a component that can be stepped on
-		bHit = GetWorld()->LineTraceSingleByChannel(RayHit, CameraPosition, CameraPosition + FVector(0.f, 0.f, FMath::Abs(GravityVariables.FloorTraceRange) * -1.f),
-			ECollisionChannel::ECC_Visibility, RayTraceParams);
-
-		// Check if we need to float the Pawn over uneven terrain
-		if (GravityVariables.RespondToUnevenTerrain
-			&& bHit && RayHit.GetComponent()->CanCharacterStepUpOn == ECanBeCharacterBase::ECB_Yes
-			&& (RayHit.Distance + GravityVariables.FloorTraceTolerance) < GravityVariables.FloorTraceRange
-			&& (GravityVariables.FloorTraceRange - (RayHit.Distance + GravityVariables.FloorTraceTolerance)) < GravityVariables.MaxStepHeight) // Check for MaxStepHeight 
-		{
-			int Steps = FPlatformMath::RoundToInt(GravityVariables.FloorTraceTolerance / StepUpRate);
-			for (int32 i = Steps; i > 1; i--)
-			{
-				this->TeleportTo(FVector(this->GetActorLocation().X, this->GetActorLocation().Y, RayHit.Location.Z - (StepUpRate * i) + HMDLocationOffset.Z), this->GetActorRotation());
-			}
-		} 
-		
-		// Apply gravity
-		if (!bHit || RayHit.GetComponent()->CanCharacterStepUpOn != ECanBeCharacterBase::ECB_Yes)
+		// One gravity step per tick unless a fixed step rate is set
+		GravityTimestep.SetRate(GravityStepRate);
+		const int32 Steps = GravityTimestep.Advance(DeltaTime);
+
+		FVector SimLocation = GravityInterpolation.GetSimLocation(this->GetActorLocation());
+		for (int32 Step = 0; Step < Steps; Step++)
 		{
-			// Calculate gravity with acceleration and apply to the pawn
-			CurrentGravityStrength = CurrentGravityStrength * GravityVariables.Acceleration;
-			this->TeleportTo(this->GetActorLocation() + (GravityVariables.GravityDirection * CurrentGravityStrength), this->GetActorRotation());
+			const FVector NewLocation = StepGravity(SimLocation, CameraPosition + (SimLocation - this->GetActorLocation()), GravityTimestep.GetStepScale());
+			GravityInterpolation.AddStep(NewLocation - SimLocation);
+			SimLocation = NewLocation;
 		}
-		else 
+
+		// Move the pawn to where it is drawn this frame
+		const FVector DrawLocation = GravityInterpolation.GetDrawLocation(SimLocation, GravityTimestep.GetAlpha());
+		if (!DrawLocation.Equals(this->GetActorLocation()))
 		{
-			// Reset current gravity
-			CurrentGravityStrength = GravityVariables.GravityStrength;
+			this->TeleportTo(DrawLocation, this->GetActorRotation());
 		}
+	}
+	else if (!GravityInterpolation.Lag.IsZero())
+	{
+		// Gravity stopped - catch the pawn up with where the simulation ended
+		this->TeleportTo(GravityInterpolation.GetSimLocation(this->GetActorLocation()), this->GetActorRotation());
+		GravityInterpolation.Reset();
+		GravityTimestep.Reset(true);
+	}
+}
 
+// Run one gravity step from Location, tracing for a floor below TracePosition
+FVector ARunebergVR_Pawn::StepGravity(const FVector& Location, const FVector& TracePosition, float StepScale)
+{
+	// Set line trace for gravity variables
+	FHitResult RayHit(EForceInit::ForceInit);
+	FCollisionQueryParams RayTraceParams(FName(TEXT("GravityRayTrace")), true, this->GetOwner());
+
+	// Initialize Gravity Trace Hit Result var
+	RayTraceParams.bTraceComplex = true;
+	RayTraceParams.bTraceAsyncScene = true;
+	RayTraceParams.bReturnPhysicalMaterial = false;
+	
+	// Do a line trace and check for a component that can be stepped on
+	bHit = GetWorld()->LineTraceSingleByChannel(RayHit, TracePosition, TracePosition + FVector(0.f, 0.f, FMath::Abs(GravityVariables.FloorTraceRange) * -1.f),
+		ECollisionChannel::ECC_Visibility, RayTraceParams);
+
+	FVector NewLocation = Location;
+
+	// Check if we need to float the Pawn over uneven terrain
+	if (GravityVariables.RespondToUnevenTerrain
+		&& bHit && RayHit.GetComponent()->CanCharacterStepUpOn == ECanBeCharacterBase::ECB_Yes
+		&& (RayHit.Distance + GravityVariables.FloorTraceTolerance) < GravityVariables.FloorTraceRange
+		&& (GravityVariables.FloorTraceRange - (RayHit.Distance + GravityVariables.FloorTraceTolerance)) < GravityVariables.MaxStepHeight) // Check for MaxStepHeight 
+	{
+		// Step up to the last StepUpRate increment below the floor offset
+		int Steps = FPlatformMath::RoundToInt(GravityVariables.FloorTraceTolerance / StepUpRate);
+		if (Steps > 1)
+		{
+			NewLocation.Z = RayHit.Location.Z - (StepUpRate * 2) + HMDLocationOffset.Z;
+		}
+	} 
+	
+	// Apply gravity
+	if (!bHit || RayHit.GetComponent()->CanCharacterStepUpOn != ECanBeCharacterBase::ECB_Yes)
+	{
+		// Calculate gravity with acceleration and apply to the pawn
+		CurrentGravityStrength = CurrentGravityStrength * FMath::Pow(GravityVariables.Acceleration, StepScale);
+		NewLocation += GravityVariables.GravityDirection * CurrentGravityStrength * StepScale;
 	}
+	else 
+	{
+		// Reset current gravity
+		CurrentGravityStrength = GravityVariables.GravityStrength;
+	}
+
+	return NewLocation;
 }
 
 // Override all default pawn values
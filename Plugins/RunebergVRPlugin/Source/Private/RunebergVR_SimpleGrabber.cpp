@@ -12,6 +12,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 */
 
 #include "RunebergVR_SimpleGrabber.h"
+#include "RunebergVR_Tags.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "Components/StaticMeshComponent.h"
 
@@ -44,25 +45,86 @@ void URunebergVR_SimpleGrabber::BeginPlay()
 	SphereComponent->AttachToComponent(GetAttachParent(), FAttachmentTransformRules::SnapToTargetNotIncludingScale, NAME_None);
 	SphereComponent->BodyInstance.SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
 	SphereComponent->BodyInstance.SetResponseToChannel(ECC_PhysicsBody, ECR_Overlap);
+
+	// No overlap events until we grab
+	SetGrabOverlapsEnabled(false);
 }
 
 void URunebergVR_SimpleGrabber::OnBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
-	OnEndOverlap(OverlappedComponent, OtherActor, OtherComp, OtherBodyIndex);
+	if (isGrabbing && !GrabbedObject && !GrabbedComponent && OtherComp && !Cast<APawn>(OtherActor) && (int)OtherComp->GetCollisionObjectType() == ObjectTypeID) {
+		GrabCandidates.AddUnique(OtherComp);
+
+		// Grab straight away unless Grab is still gathering what's already in reach
+		if (!bCollectingCandidates) {
+			GrabBestCandidate();
+		}
+	}
 }
 
 void URunebergVR_SimpleGrabber::OnEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
 {
-	if (isGrabbing && !GrabbedObject && !GrabbedComponent && !Cast<APawn>(OtherActor) && (int)OtherComp->GetCollisionObjectType() == ObjectTypeID) {
-		GrabbedObject = OtherActor;
-		GrabbedComponent = OtherComp;
+	GrabCandidates.RemoveSwap(OtherComp);
+}
+
+// Turn the sphere's overlap events on or off
+void URunebergVR_SimpleGrabber::SetGrabOverlapsEnabled(bool bEnabled)
+{
+	GrabCandidates.Reset();
+
+	// Clear overlaps left from before, so everything in reach begins overlapping again
+	if (bEnabled) {
+		SphereComponent->UpdateOverlaps();
+	}
+
+	SphereComponent->SetGenerateOverlapEvents(bEnabled);
+
+	// Pick up what's already in reach
+	if (bEnabled) {
+		SphereComponent->UpdateOverlaps();
+	}
+}
+
+// Grab the best candidate, if any
+void URunebergVR_SimpleGrabber::GrabBestCandidate()
+{
+	const FVector GrabLocation = SphereComponent->GetComponentLocation();
+	UPrimitiveComponent* BestComponent = nullptr;
+	bool bBestHasPriority = false;
+	float BestDistanceSquared = BIG_NUMBER;
+
+	for (const TWeakObjectPtr<UPrimitiveComponent>& Candidate : GrabCandidates) {
+		UPrimitiveComponent* Component = Candidate.Get();
+		if (!Component || !Component->GetOwner()) {
+			continue;
+		}
 
-		if (GrabbedObject && GrabbedComponent) {
-			GrabbedObject->DisableComponentsSimulatePhysics();
-			GrabbedObject->GetRootComponent()->AttachToComponent(GetAttachParent(), FAttachmentTransformRules::KeepWorldTransform, NAME_None);
+		// Priority candidates first, then the nearest (or first) of those
+		const bool bHasPriority = !PriorityTag.IsNone() && (FRunebergVRTags::HasTag(Component, PriorityTag) || FRunebergVRTags::HasTag(Component->GetOwner(), PriorityTag));
+		const float DistanceSquared = bGrabNearest ? FVector::DistSquared(GrabLocation, Component->GetComponentLocation()) : 0.f;
+		if (!BestComponent || (bHasPriority && !bBestHasPriority) || (bHasPriority == bBestHasPriority && DistanceSquared < BestDistanceSquared)) {
+			BestComponent = Component;
+			bBestHasPriority = bHasPriority;
+			BestDistanceSquared = DistanceSquared;
 		}
 	}
 
+	if (BestComponent) {
+		GrabComponent(BestComponent);
+	}
+}
+
+// Attach an overlapping component's actor to the grabber
+void URunebergVR_SimpleGrabber::GrabComponent(UPrimitiveComponent* Component)
+{
+	GrabbedObject = Component->GetOwner();
+	GrabbedComponent = Component;
+
+	GrabbedObject->DisableComponentsSimulatePhysics();
+	GrabbedObject->GetRootComponent()->AttachToComponent(GetAttachParent(), FAttachmentTransformRules::KeepWorldTransform, NAME_None);
+
+	// Holding something, no more overlaps needed
+	SetGrabOverlapsEnabled(false);
 }
 
 // Enable grabbing mode
@@ -70,12 +132,23 @@ void URunebergVR_SimpleGrabber::Grab(int _ObjectTypeID)
 {
 	ObjectTypeID = _ObjectTypeID;
 	isGrabbing = true;
+
+	if (GrabbedObject) {
+		return;
+	}
+
+	// Gather everything already in reach, then grab the best of it
+	bCollectingCandidates = true;
+	SetGrabOverlapsEnabled(true);
+	bCollectingCandidates = false;
+	GrabBestCandidate();
 }
 
 // Disable grabbing mode
 void URunebergVR_SimpleGrabber::Release(bool EnablePhysics)
 {
 	isGrabbing = false;
+	SetGrabOverlapsEnabled(false);
 
 	// Detach grabbed object from grabber
 	if (GrabbedObject) {
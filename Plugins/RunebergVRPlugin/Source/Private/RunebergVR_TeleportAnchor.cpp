@@ -0,0 +1,188 @@
+// Copyright (C) 2017 Runeberg (github: 1runeberg, UE4 Forums: runeberg)
+
+/*
+The MIT License (MIT)
+Copyright (c) 2017 runeberg (github: 1runeberg, UE4 Forums: runeberg)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "RunebergVR_TeleportAnchor.h"
+#include "Engine/World.h"
+
+const float FRunebergVRTeleportAnchorHash::CellSize = 200.f;
+
+// Anchor hashes of all live worlds
+static TMap<TWeakObjectPtr<UWorld>, TSharedPtr<FRunebergVRTeleportAnchorHash>> AnchorHashes;
+
+// Get the anchor hash for a world, creating it if needed
+FRunebergVRTeleportAnchorHash& FRunebergVRTeleportAnchorHash::Get(UWorld* World)
+{
+	TSharedPtr<FRunebergVRTeleportAnchorHash>& AnchorHash = AnchorHashes.FindOrAdd(World);
+	if (!AnchorHash.IsValid())
+	{
+		AnchorHash = MakeShareable(new FRunebergVRTeleportAnchorHash());
+	}
+
+	return *AnchorHash;
+}
+
+// Get the anchor hash for a world if it has one, never creates it
+FRunebergVRTeleportAnchorHash* FRunebergVRTeleportAnchorHash::Find(UWorld* World)
+{
+	TSharedPtr<FRunebergVRTeleportAnchorHash>* AnchorHash = AnchorHashes.Find(World);
+	return AnchorHash ? AnchorHash->Get() : nullptr;
+}
+
+// Drop the anchor hash of a world that is being cleaned up
+void FRunebergVRTeleportAnchorHash::OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+	AnchorHashes.Remove(World);
+}
+
+// Hash cell of a world location
+FIntVector FRunebergVRTeleportAnchorHash::GetCell(const FVector& Location)
+{
+	return FIntVector(FMath::FloorToInt(Location.X / CellSize),
+		FMath::FloorToInt(Location.Y / CellSize),
+		FMath::FloorToInt(Location.Z / CellSize));
+}
+
+// Add or move an anchor
+void FRunebergVRTeleportAnchorHash::UpdateAnchor(URunebergVR_TeleportAnchor* Anchor)
+{
+	const FVector Location = Anchor->GetComponentLocation();
+	const FIntVector NewCell = GetCell(Location);
+
+	// Already hashed - update in place if it stayed in its cell
+	if (FIntVector* OldCell = AnchorCells.Find(Anchor))
+	{
+		TArray<FAnchorEntry>& OldEntries = Cells.FindChecked(*OldCell);
+		if (*OldCell == NewCell)
+		{
+			for (FAnchorEntry& Entry : OldEntries)
+			{
+				if (Entry.Anchor == Anchor)
+				{
+					Entry.Location = Location;
+					break;
+				}
+			}
+			return;
+		}
+
+		RemoveAnchor(Anchor);
+	}
+
+	Cells.FindOrAdd(NewCell).Add({ Anchor, Location });
+	AnchorCells.Add(Anchor, NewCell);
+}
+
+// Remove an anchor
+void FRunebergVRTeleportAnchorHash::RemoveAnchor(URunebergVR_TeleportAnchor* Anchor)
+{
+	FIntVector Cell;
+	if (!AnchorCells.RemoveAndCopyValue(Anchor, Cell))
+	{
+		return;
+	}
+
+	TArray<FAnchorEntry>& Entries = Cells.FindChecked(Cell);
+	Entries.RemoveAllSwap([Anchor](const FAnchorEntry& Entry) { return Entry.Anchor == Anchor; });
+
+	// Don't keep empty cells around
+	if (Entries.Num() == 0)
+	{
+		Cells.Remove(Cell);
+	}
+}
+
+// Find the closest enabled anchor within Radius of Point
+URunebergVR_TeleportAnchor* FRunebergVRTeleportAnchorHash::FindNearestAnchor(const FVector& Point, float Radius) const
+{
+	if (Cells.Num() == 0 || Radius <= 0.f)
+	{
+		return nullptr;
+	}
+
+	const FIntVector MinCell = GetCell(Point - FVector(Radius));
+	const FIntVector MaxCell = GetCell(Point + FVector(Radius));
+
+	URunebergVR_TeleportAnchor* NearestAnchor = nullptr;
+	float NearestDistSq = FMath::Square(Radius);
+
+	// Only visit the cells the search sphere overlaps
+	for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; Z++)
+			{
+				const TArray<FAnchorEntry>* Entries = Cells.Find(FIntVector(X, Y, Z));
+				if (!Entries)
+				{
+					continue;
+				}
+
+				for (const FAnchorEntry& Entry : *Entries)
+				{
+					const float DistSq = FVector::DistSquared(Point, Entry.Location);
+					if (DistSq <= NearestDistSq && Entry.Anchor->bAnchorEnabled)
+					{
+						NearestDistSq = DistSq;
+						NearestAnchor = Entry.Anchor;
+					}
+				}
+			}
+		}
+	}
+
+	return NearestAnchor;
+}
+
+// Sets default values for this component's properties
+URunebergVR_TeleportAnchor::URunebergVR_TeleportAnchor()
+{
+	// Anchors don't need to tick, they only move in the hash when their transform changes
+	PrimaryComponentTick.bCanEverTick = false;
+	bWantsOnUpdateTransform = true;
+}
+
+// Add to the world's anchor hash
+void URunebergVR_TeleportAnchor::OnRegister()
+{
+	Super::OnRegister();
+
+	if (GetWorld() && GetWorld()->IsGameWorld())
+	{
+		FRunebergVRTeleportAnchorHash::Get(GetWorld()).UpdateAnchor(this);
+	}
+}
+
+// Remove from the world's anchor hash
+void URunebergVR_TeleportAnchor::OnUnregister()
+{
+	// Find only, unregistering during world cleanup must not bring the hash back
+	FRunebergVRTeleportAnchorHash* AnchorHash = FRunebergVRTeleportAnchorHash::Find(GetWorld());
+	if (AnchorHash)
+	{
+		AnchorHash->RemoveAnchor(this);
+	}
+
+	Super::OnUnregister();
+}
+
+// Keep the hash in sync with anchors that move at runtime
+void URunebergVR_TeleportAnchor::OnUpdateTransform(EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	Super::OnUpdateTransform(UpdateTransformFlags, Teleport);
+
+	if (IsRegistered() && GetWorld() && GetWorld()->IsGameWorld())
+	{
+		FRunebergVRTeleportAnchorHash::Get(GetWorld()).UpdateAnchor(this);
+	}
+}
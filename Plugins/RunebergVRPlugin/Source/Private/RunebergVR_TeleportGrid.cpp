@@ -0,0 +1,223 @@
+// Copyright (C) 2016, 2017 Runeberg (github: 1runeberg, UE4 Forums: runeberg)
+
+/*
+The MIT License (MIT)
+Copyright (c) 2016, 2017 runeberg (github: 1runeberg, UE4 Forums: runeberg)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "RunebergVR_TeleportGrid.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Runtime/NavigationSystem/Public/NavigationSystem.h"
+#include "NavigationData.h"
+
+// Bake the grid from the current navigation data
+int32 URunebergVR_TeleportGrid::BakeFromNavMesh(UObject* WorldContextObject, FBox BakeBounds)
+{
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+	UNavigationSystemV1* NavSystem = World ? Cast<UNavigationSystemV1>(World->GetNavigationSystem()) : nullptr;
+	ANavigationData* NavData = NavSystem ? NavSystem->GetDefaultNavDataInstance(FNavigationSystem::DontCreate) : nullptr;
+
+	if (!NavData || CellSize < 1.f || HeightStep < 0.01f)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[TELEPORT GRID] No navigation data found or invalid cell settings, grid not baked."));
+		return 0;
+	}
+
+	// Use the nav mesh bounds if none were given
+	if (!BakeBounds.IsValid)
+	{
+		BakeBounds = NavData->GetBounds();
+	}
+
+	// Keep the asset at a sane size
+	const int32 MaxCellsPerAxis = 4096;
+	GridOrigin = BakeBounds.Min;
+	GridSize.X = FMath::Clamp(FMath::CeilToInt((BakeBounds.Max.X - BakeBounds.Min.X) / CellSize), 0, MaxCellsPerAxis);
+	GridSize.Y = FMath::Clamp(FMath::CeilToInt((BakeBounds.Max.Y - BakeBounds.Min.Y) / CellSize), 0, MaxCellsPerAxis);
+
+	const int32 NumCells = GridSize.X * GridSize.Y;
+	CellStates.Init((uint8)ETeleportGridQuery::Invalid, NumCells);
+	CornerHeights.Init(0, (GridSize.X + 1) * (GridSize.Y + 1));
+
+	if (NumCells == 0)
+	{
+		MarkPackageDirty();
+		return 0;
+	}
+
+	// Samples project down from the top of the bounds so the topmost floor of each column wins
+	const float BoundsHeight = BakeBounds.Max.Z - BakeBounds.Min.Z;
+	const FVector SampleExtent = FVector(SampleTolerance, SampleTolerance, BoundsHeight);
+	auto SampleFloor = [&](float X, float Y, float& OutZ) -> bool
+	{
+		FNavLocation NavLocation;
+		if (NavSystem->ProjectPointToNavigation(FVector(X, Y, BakeBounds.Max.Z), NavLocation, SampleExtent, NavData))
+		{
+			OutZ = NavLocation.Location.Z;
+			return true;
+		}
+		return false;
+	};
+
+	// Sample the cell corners once, neighbouring cells share them
+	const int32 CornersX = GridSize.X + 1;
+	TArray<float> CornerSamples;
+	TArray<bool> CornerValid;
+	CornerSamples.SetNumZeroed(CornersX * (GridSize.Y + 1));
+	CornerValid.SetNumZeroed(CornersX * (GridSize.Y + 1));
+
+	for (int32 Y = 0; Y <= GridSize.Y; Y++)
+	{
+		for (int32 X = 0; X <= GridSize.X; X++)
+		{
+			const int32 Index = Y * CornersX + X;
+			CornerValid[Index] = SampleFloor(GridOrigin.X + X * CellSize, GridOrigin.Y + Y * CellSize, CornerSamples[Index]);
+		}
+	}
+
+	// Classify each cell from its centre and corner samples
+	for (int32 Y = 0; Y < GridSize.Y; Y++)
+	{
+		for (int32 X = 0; X < GridSize.X; X++)
+		{
+			float CenterZ = 0.f;
+			const bool bCenterValid = SampleFloor(GridOrigin.X + (X + 0.5f) * CellSize, GridOrigin.Y + (Y + 0.5f) * CellSize, CenterZ);
+
+			int32 NumValid = bCenterValid ? 1 : 0;
+			float MinZ = bCenterValid ? CenterZ : MAX_flt;
+			float MaxZ = bCenterValid ? CenterZ : -MAX_flt;
+
+			const int32 Corners[4] = { Y * CornersX + X, Y * CornersX + X + 1, (Y + 1) * CornersX + X, (Y + 1) * CornersX + X + 1 };
+			for (int32 Corner : Corners)
+			{
+				if (CornerValid[Corner])
+				{
+					NumValid++;
+					MinZ = FMath::Min(MinZ, CornerSamples[Corner]);
+					MaxZ = FMath::Max(MaxZ, CornerSamples[Corner]);
+				}
+			}
+
+			const int32 CellIndex = Y * GridSize.X + X;
+			if (NumValid == 0)
+			{
+				// Nav mesh islands smaller than a cell can sit between the samples, search the whole cell column for them
+				FNavLocation NavLocation;
+				const FVector CellCenter(GridOrigin.X + (X + 0.5f) * CellSize, GridOrigin.Y + (Y + 0.5f) * CellSize, BakeBounds.GetCenter().Z);
+				if (NavSystem->ProjectPointToNavigation(CellCenter, NavLocation, FVector(CellSize * 0.5f, CellSize * 0.5f, BoundsHeight * 0.5f), NavData))
+				{
+					CellStates[CellIndex] = (uint8)ETeleportGridQuery::Unresolved;
+				}
+				continue;
+			}
+
+			// The floor is interpolated from the corners, so the centre has to sit on that surface too
+			const float CornerAverageZ = NumValid == 5 ? (CornerSamples[Corners[0]] + CornerSamples[Corners[1]] + CornerSamples[Corners[2]] + CornerSamples[Corners[3]]) * 0.25f : 0.f;
+			if (NumValid == 5 && (MaxZ - MinZ) <= MaxCellHeightVariance && FMath::Abs(CenterZ - CornerAverageZ) <= HeightStep
+				&& (MinZ - GridOrigin.Z) / HeightStep >= MIN_int16 && (MaxZ - GridOrigin.Z) / HeightStep <= MAX_int16)
+			{
+				CellStates[CellIndex] = (uint8)ETeleportGridQuery::Valid;
+			}
+			else
+			{
+				CellStates[CellIndex] = (uint8)ETeleportGridQuery::Unresolved;
+			}
+		}
+	}
+
+	// Empty cells touching a nav mesh cell may still have nav mesh along their edges, let the nav mesh decide those
+	TArray<uint8> BakedStates = CellStates;
+	int32 NumValidCells = 0;
+	for (int32 Y = 0; Y < GridSize.Y; Y++)
+	{
+		for (int32 X = 0; X < GridSize.X; X++)
+		{
+			const int32 CellIndex = Y * GridSize.X + X;
+			if (BakedStates[CellIndex] == (uint8)ETeleportGridQuery::Valid)
+			{
+				NumValidCells++;
+				continue;
+			}
+
+			if (BakedStates[CellIndex] != (uint8)ETeleportGridQuery::Invalid)
+			{
+				continue;
+			}
+
+			for (int32 NeighbourY = FMath::Max(Y - 1, 0); NeighbourY <= FMath::Min(Y + 1, GridSize.Y - 1); NeighbourY++)
+			{
+				for (int32 NeighbourX = FMath::Max(X - 1, 0); NeighbourX <= FMath::Min(X + 1, GridSize.X - 1); NeighbourX++)
+				{
+					if (BakedStates[NeighbourY * GridSize.X + NeighbourX] != (uint8)ETeleportGridQuery::Invalid)
+					{
+						CellStates[CellIndex] = (uint8)ETeleportGridQuery::Unresolved;
+					}
+				}
+			}
+		}
+	}
+
+	// Corner heights of valid cells
+	for (int32 Index = 0; Index < CornerSamples.Num(); Index++)
+	{
+		if (CornerValid[Index])
+		{
+			CornerHeights[Index] = (int16)FMath::Clamp(FMath::RoundToFloat((CornerSamples[Index] - GridOrigin.Z) / HeightStep), (float)MIN_int16, (float)MAX_int16);
+		}
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("[TELEPORT GRID] Baked %d x %d grid, %d valid cells."), GridSize.X, GridSize.Y, NumValidCells);
+
+	MarkPackageDirty();
+	return NumValidCells;
+}
+
+// Check a location against the grid
+ETeleportGridQuery URunebergVR_TeleportGrid::QueryLocation(const FVector& Point, const FVector& Extent, FVector& OutLocation) const
+{
+	if (CellSize < 1.f || CellStates.Num() != GridSize.X * GridSize.Y || CornerHeights.Num() != (GridSize.X + 1) * (GridSize.Y + 1))
+	{
+		return ETeleportGridQuery::Unresolved;
+	}
+
+	const float GridX = (Point.X - GridOrigin.X) / CellSize;
+	const float GridY = (Point.Y - GridOrigin.Y) / CellSize;
+	const int32 X = FMath::FloorToInt(GridX);
+	const int32 Y = FMath::FloorToInt(GridY);
+
+	// Outside the baked area
+	if (X < 0 || Y < 0 || X >= GridSize.X || Y >= GridSize.Y)
+	{
+		return ETeleportGridQuery::Unresolved;
+	}
+
+	const int32 CellIndex = Y * GridSize.X + X;
+	const ETeleportGridQuery CellState = (ETeleportGridQuery)CellStates[CellIndex];
+
+	if (CellState == ETeleportGridQuery::Valid)
+	{
+		// Floor under the point, interpolated from the cell's corners
+		const int32 CornersX = GridSize.X + 1;
+		const int32 Corner = Y * CornersX + X;
+		const float Height = FMath::BiLerp((float)CornerHeights[Corner], (float)CornerHeights[Corner + 1],
+			(float)CornerHeights[Corner + CornersX], (float)CornerHeights[Corner + CornersX + 1], GridX - X, GridY - Y);
+		const float FloorZ = GridOrigin.Z + Height * HeightStep;
+
+		// Only trust the grid for points at the baked floor, anything else may be on another floor
+		if (FMath::Abs(Point.Z - FloorZ) > Extent.Z + HeightStep)
+		{
+			return ETeleportGridQuery::Unresolved;
+		}
+
+		OutLocation = FVector(Point.X, Point.Y, FloorZ);
+	}
+
+	return CellState;
+}
@@ -12,11 +12,53 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 */
 
 #include "RunebergVR_Teleporter.h"
+#include "RunebergVRPlugin.h"
+#include "RunebergVR_Movement.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "Kismet/GameplayStatics.h"
 #include "Engine.h"
 #include "HeadMountedDisplayFunctionLibrary.h"
 #include "IHeadMountedDisplay.h"
+#include "Engine/LevelStreamingVolume.h"
+#include "ContentStreaming.h"
+#include "ProceduralMeshComponent.h"
+#include "NavigationData.h"
+#include "Components/BoxComponent.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "StaticMeshResources.h"
+#if WITH_EDITOR
+#include "ScopedTransaction.h"
+#endif
+
+// Teleporter cost per frame - "stat RunebergVR" in game, or "csvprofile start/stop" to compare captures across builds
+DECLARE_CYCLE_STAT(TEXT("Teleporter Tick"), STAT_TeleporterTick, STATGROUP_RunebergVR);
+DECLARE_CYCLE_STAT(TEXT("Teleport Arc Trace"), STAT_TeleportArcTrace, STATGROUP_RunebergVR);
+DECLARE_CYCLE_STAT(TEXT("Teleport Arc Draw"), STAT_TeleportArcDraw, STATGROUP_RunebergVR);
+DECLARE_CYCLE_STAT(TEXT("Teleport Ray Trace"), STAT_TeleportRayTrace, STATGROUP_RunebergVR);
+DECLARE_CYCLE_STAT(TEXT("Teleport Ray Draw"), STAT_TeleportRayDraw, STATGROUP_RunebergVR);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Teleport Traces"), STAT_TeleportTraces, STATGROUP_RunebergVR);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Teleport Nav Queries"), STAT_TeleportNavQueries, STATGROUP_RunebergVR);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Teleport Components Created"), STAT_TeleportComponentsCreated, STATGROUP_RunebergVR);
+
+CSV_DEFINE_CATEGORY(RunebergVRTeleporter, true);
+
+// Count per frame stats for the stats system, csv captures and the component's own perf counters
+#define TELEPORT_COUNT_STAT(Stat, CsvStat, Count) \
+	do \
+	{ \
+		INC_DWORD_STAT_BY(Stat, Count); \
+		CSV_CUSTOM_STAT(RunebergVRTeleporter, CsvStat, (int32)(Count), ECsvCustomStatOp::Accumulate); \
+		PerfCounters.CsvStat += (Count); \
+	} while (0)
+
+// Point at a fraction (0-1) along an arc's point list, so arcs with different point counts can be blended
+static FVector SampleArcAtFraction(const TArray<FVector>& Points, float Fraction)
+{
+	const float Index = FMath::Clamp(Fraction, 0.f, 1.f) * (Points.Num() - 1);
+	const int32 Lower = FMath::FloorToInt(Index);
+	const int32 Upper = FMath::Min(Lower + 1, Points.Num() - 1);
+	return FMath::Lerp(Points[Lower], Points[Upper], Index - Lower);
+}
 
 // Sets default values for this component's properties
 URunebergVR_Teleporter::URunebergVR_Teleporter()
@@ -62,44 +104,306 @@ void URunebergVR_Teleporter::BeginPlay()
 
 }
 
+// Called when the game ends
+void URunebergVR_Teleporter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Don't leave streaming volumes paused if we go away mid pre-warm
+	if (GetWorld())
+	{
+		GetWorld()->GetTimerManager().ClearTimer(FadeTimerHandle);
+		if (bIsPreWarming)
+		{
+			EndPreWarm();
+		}
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 bool URunebergVR_Teleporter::IsNavPointReachable(const FVector & Point, FNavLocation & OutLocation, const FVector & Extent)
 {
+	// Check the baked teleport grid first, only cells it can't resolve need a nav mesh query
+	if (TeleportGrid)
+	{
+		FVector GridLocation;
+		ETeleportGridQuery GridResult = TeleportGrid->QueryLocation(Point, Extent, GridLocation);
+
+		if (GridResult == ETeleportGridQuery::Valid)
+		{
+			OutLocation = FNavLocation(GridLocation);
+			return true;
+		}
+		else if (GridResult == ETeleportGridQuery::Invalid)
+		{
+			return false;
+		}
+	}
+
 	UNavigationSystemV1* NavSystem = Cast<UNavigationSystemV1>(GetWorld()->GetNavigationSystem());
+	if (!NavSystem)
+	{
+		return false;
+	}
+
 	TArray<FNavDataConfig> supportedAgents = NavSystem->GetSupportedAgents();
 	if (supportedAgents.Num()>0)
 	{
 		FNavDataConfig adata = NavSystem->GetSupportedAgents()[0];
 		if (adata.IsValid()) 
+		{
+			TELEPORT_COUNT_STAT(STAT_TeleportNavQueries, NavQueries, 1);
 			return NavSystem->ProjectPointToNavigation(
 				Point,
 				OutLocation,
 				Extent,
 				&adata.DefaultProperties, 0);
+		}
 	}
 	return false;
 }
 
+// Check (or start checking) if a nav location can be walked to from the pawn
+bool URunebergVR_Teleporter::IsPathReachable(const FNavLocation& Destination)
+{
+	// Cache per target poly, or per coarse cell when the teleport grid resolved the location without a poly
+	if (Destination.HasNodeRef())
+	{
+		TargetPathKey = Destination.NodeRef;
+	}
+	else
+	{
+		const FIntVector Cell(Destination.Location / 50.f);
+		TargetPathKey = (1ull << 63) | ((uint64)(Cell.X & 0x1FFFFF) << 42) | ((uint64)(Cell.Y & 0x1FFFFF) << 21) | (uint64)(Cell.Z & 0x1FFFFF);
+	}
+
+	// Nothing to check against without nav data or a pawn on the nav mesh
+	UNavigationSystemV1* NavSystem = Cast<UNavigationSystemV1>(GetWorld()->GetNavigationSystem());
+	ANavigationData* NavData = NavSystem ? NavSystem->GetDefaultNavDataInstance(FNavigationSystem::DontCreate) : nullptr;
+	if (!NavData)
+	{
+		return true;
+	}
+
+	// Find the pawn's poly first, cached results are only valid from where they were checked
+	FNavLocation PawnLocation;
+	if (!NavSystem->ProjectPointToNavigation(GetOwner()->GetActorLocation(), PawnLocation, FVector(50.f, 50.f, 250.f), NavData))
+	{
+		return true;
+	}
+
+	if (PawnLocation.NodeRef != PathCacheStartPoly)
+	{
+		PathReachableCache.Reset();
+		PathCacheStartPoly = PawnLocation.NodeRef;
+	}
+
+	if (const bool* bCachedResult = PathReachableCache.Find(TargetPathKey))
+	{
+		return *bCachedResult;
+	}
+
+	// Unknown until a query comes back - throttle queries, one in flight at a time
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+	if (PendingPathQueryID != INVALID_NAVQUERYID || (LastPathQueryTime >= 0.f && CurrentTime - LastPathQueryTime < PathCheckInterval))
+	{
+		return false;
+	}
+
+	// Ask for a path on the async navigation queue
+	FPathFindingQuery Query(this, *NavData, PawnLocation.Location, Destination.Location);
+	PendingPathKey = TargetPathKey;
+	PendingPathStartPoly = PathCacheStartPoly;
+	LastPathQueryTime = CurrentTime;
+	TELEPORT_COUNT_STAT(STAT_TeleportNavQueries, NavQueries, 2);
+	PendingPathQueryID = NavSystem->FindPathAsync(NavData->GetConfig(), Query,
+		FNavPathQueryDelegate::CreateUObject(this, &URunebergVR_Teleporter::OnPathQueryFinished), EPathFindingMode::Regular);
+
+	return false;
+}
+
+// Async path query result
+void URunebergVR_Teleporter::OnPathQueryFinished(uint32 QueryID, ENavigationQueryResult::Type Result, FNavPathSharedPtr Path)
+{
+	if (QueryID != PendingPathQueryID)
+	{
+		return;
+	}
+	PendingPathQueryID = INVALID_NAVQUERYID;
+
+	// The pawn moved to another poly while the query ran, the result no longer applies
+	if (PendingPathStartPoly != PathCacheStartPoly)
+	{
+		return;
+	}
+
+	// A partial path ends somewhere else - the target is on a disconnected island
+	const bool bReachable = Result == ENavigationQueryResult::Success && Path.IsValid() && !Path->IsPartial();
+	PathReachableCache.Add(PendingPathKey, bReachable);
+
+	// Update the current target straight away if this was its query
+	if (!bReachable && IsTeleporting && bIsBeamTypeTeleport && PendingPathKey == TargetPathKey)
+	{
+		bIsTargetLocationValid = false;
+	}
+}
+
 // Called every frame
 void URunebergVR_Teleporter::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	SCOPE_CYCLE_COUNTER(STAT_TeleporterTick);
 
 	if (IsTeleporting && bIsBeamTypeTeleport)
 	{
+		// Run the targeting traces at their own rate - only the latest result matters so extra steps are skipped
+		TargetingTimestep.SetRate(TargetingSimRate);
+		if (TargetingTimestep.Advance(DeltaTime) > 0)
+		{
+			if (TeleportMode == 0)
+			{
+				SimulateTeleportArc();
+			}
+			else if (TeleportMode == 1)
+			{
+				SimulateTeleportRay();
+			}
+		}
+
+		// Draw every frame, in between targeting results
 		if (TeleportMode == 0)
 		{
-			DrawTeleportArc();
+			DrawTeleportArc(TargetingTimestep.GetAlpha());
 		}
 		else if (TeleportMode == 1)
 		{
-			DrawTeleportRay();
+			DrawTeleportRay(TargetingTimestep.GetAlpha());
 		}
 	}
 }
 
-// Draw Teleport Arc
-void URunebergVR_Teleporter::DrawTeleportArc()
+// Start targeting fresh so the first frame traces straight away and nothing blends from a stale result
+void URunebergVR_Teleporter::ResetTargetingSim()
+{
+	TargetingTimestep.SetRate(TargetingSimRate);
+	TargetingTimestep.Reset(true);
+	ArcSimPoints.Empty();
+	ArcSimPointsPrev.Empty();
+	bIsTargetLocationValid = false;
+
+	// Nav mesh may have changed since the last beam
+	PathReachableCache.Reset();
+}
+
+// Move the simulated target onto the nearest teleport anchor
+bool URunebergVR_Teleporter::SnapToTeleportAnchor(const FVector& HitLocation)
+{
+	FRunebergVRTeleportAnchorHash* AnchorHash = FRunebergVRTeleportAnchorHash::Find(GetWorld());
+	URunebergVR_TeleportAnchor* Anchor = AnchorHash ? AnchorHash->FindNearestAnchor(HitLocation, AnchorSnapRadius) : nullptr;
+	if (!Anchor)
+	{
+		return false;
+	}
+
+	SimTargetLocation = Anchor->GetComponentLocation();
+
+	// Anchor rotation, or the same marker rotation rules as a regular target
+	if (Anchor->bUseAnchorRotation)
+	{
+		SimTargetRotation = Anchor->GetComponentRotation();
+	}
+	else if (CustomMarkerRotation.Equals(FRotator::ZeroRotator))
+	{
+		SimTargetRotation = CustomMarkerRotation;
+	}
+	else
+	{
+		SimTargetRotation = UKismetMathLibrary::FindLookAtRotation(SimTargetLocation, GetOwner()->GetActorLocation());
+	}
+
+	return true;
+}
+
+// Keep the latest targeting result as the one to interpolate from
+void URunebergVR_Teleporter::StoreSimResult()
+{
+	Swap(ArcSimPointsPrev, ArcSimPoints);
+	ArcSimPoints.Reset();
+	SimTargetLocationPrev = SimTargetLocation;
+	SimTargetRotationPrev = SimTargetRotation;
+	bSimTargetWasValid = bIsTargetLocationValid;
+}
+
+// Interpolate the target location and marker between the last two targeting results
+void URunebergVR_Teleporter::UpdateTargetMarker(float Alpha)
 {
+	// Glide between results of the same kind, snap when the target becomes valid or invalid
+	if (bSimTargetWasValid == bIsTargetLocationValid)
+	{
+		TargetLocation = FMath::Lerp(SimTargetLocationPrev, SimTargetLocation, Alpha);
+		TargetRotation = FQuat::Slerp(SimTargetRotationPrev.Quaternion(), SimTargetRotation.Quaternion(), Alpha).Rotator();
+	}
+	else
+	{
+		TargetLocation = SimTargetLocation;
+		TargetRotation = SimTargetRotation;
+	}
+
+	if (bIsTargetLocationValid)
+	{
+		// Apply marker position and orientation
+		SetTargetMarkerLocationAndRotation(TargetLocation, TargetRotation);
+		SetTargetMarkerVisibility(true);
+	}
+	else
+	{
+		SetTargetMarkerVisibility(false);
+	}
+}
+
+// Arc trace rate that gives the adaptive segment count, based on the last arc trace
+float URunebergVR_Teleporter::GetAdaptiveArcSimFrequency() const
+{
+	const int32 MinSegments = FMath::Max(ArcMinSegments, 2);
+	const int32 MaxSegments = FMath::Max(ArcMaxSegments, MinSegments);
+
+	// Nothing to go by yet, start at full detail
+	if (ArcSimPoints.Num() < 3 || LastArcFlightTime <= KINDA_SMALL_NUMBER)
+	{
+		return MaxSegments / MaxSimTime;
+	}
+
+	// Arc length and how much it turns from start to end
+	float ArcLength = 0.f;
+	for (int32 i = 1; i < ArcSimPoints.Num(); i++)
+	{
+		ArcLength += FVector::Distance(ArcSimPoints[i - 1], ArcSimPoints[i]);
+	}
+
+	const FVector StartDirection = (ArcSimPoints[1] - ArcSimPoints[0]).GetSafeNormal();
+	const FVector EndDirection = (ArcSimPoints.Last() - ArcSimPoints.Last(1)).GetSafeNormal();
+	const float TurnAngle = FMath::Acos(FMath::Clamp(FVector::DotProduct(StartDirection, EndDirection), -1.f, 1.f));
+
+	// Far arcs take up less of the screen
+	float ViewDistance = 0.f;
+	APlayerCameraManager* CameraManager = UGameplayStatics::GetPlayerCameraManager(this, 0);
+	if (CameraManager)
+	{
+		ViewDistance = FVector::Distance(CameraManager->GetCameraLocation(), ArcSimPoints[ArcSimPoints.Num() / 2]);
+	}
+
+	// Segments get longer with distance and shorter with curvature
+	const float SegmentLength = FMath::Max(ArcSegmentLength, 1.f) * (1.f + ViewDistance / FMath::Max(ArcLODDistance, 1.f)) / (1.f + TurnAngle);
+	const int32 Segments = FMath::Clamp(FMath::CeilToInt(ArcLength / SegmentLength), MinSegments, MaxSegments);
+
+	// Same flight time spread over the wanted segment count
+	return Segments / LastArcFlightTime;
+}
+
+// Trace the teleport arc and check the target location
+void URunebergVR_Teleporter::SimulateTeleportArc()
+{
+	SCOPE_CYCLE_COUNTER(STAT_TeleportArcTrace);
+	CSV_SCOPED_TIMING_STAT(RunebergVRTeleporter, ArcTrace);
 	// Set Teleport Arc Parameters
 	FPredictProjectilePathParams Params = FPredictProjectilePathParams(
 		ArcRadius,
@@ -112,76 +416,128 @@ void URunebergVR_Teleporter::DrawTeleportArc()
 	Params.bTraceComplex = false;
 	Params.DrawDebugType = EDrawDebugTrace::None;
 	Params.DrawDebugTime = 0.f;
-	Params.SimFrequency = SimFrequency;
+	Params.SimFrequency = bAdaptiveArcResolution ? GetAdaptiveArcSimFrequency() : SimFrequency;
 	Params.ObjectTypes = TeleportBoundary_ObjectTypes;
 	Params.OverrideGravityZ = ArcOverrideGravity;
-	Params.bTraceWithChannel = false;
+	Params.bTraceWithChannel = bTraceTeleportChannel;
+	Params.TraceChannel = TeleportTraceChannel;
 
 	// Do the arc trace
 	FPredictProjectilePathResult PredictResult;
 	bool bHit = UGameplayStatics::PredictProjectilePath(this, Params, PredictResult);
+	TELEPORT_COUNT_STAT(STAT_TeleportTraces, Traces, PredictResult.PathData.Num());
 
-	// Show Target Marker (if a valid teleport location)
+	// Save the arc points
+	StoreSimResult();
+	const int32 MaxArcPoints = FMath::Max(FMath::Max(ArcMaxSegments, ArcMinSegments), 2) + 1;
+	if (bAdaptiveArcResolution && PredictResult.PathData.Num() > MaxArcPoints)
+	{
+		// The rate came from the last arc's flight time, a much longer arc this time would overshoot the segment budget
+		for (int32 i = 0; i < MaxArcPoints; i++)
+		{
+			const float Index = (float)i / (MaxArcPoints - 1) * (PredictResult.PathData.Num() - 1);
+			const int32 Lower = FMath::FloorToInt(Index);
+			const int32 Upper = FMath::Min(Lower + 1, PredictResult.PathData.Num() - 1);
+			ArcSimPoints.Add(FMath::Lerp(PredictResult.PathData[Lower].Location, PredictResult.PathData[Upper].Location, Index - Lower));
+		}
+	}
+	else
+	{
+		for (const FPredictProjectilePathPointData& PathPoint : PredictResult.PathData)
+		{
+			ArcSimPoints.Add(PathPoint.Location);
+		}
+	}
+	LastArcFlightTime = PredictResult.PathData.Num() > 0 ? PredictResult.PathData.Last().Time : 0.f;
+
+	// Check for a valid teleport location
+	bIsTargetLocationValid = false;
 	if (bHit)
 	{
 		FNavLocation CheckLocation;
-		UNavigationSystemV1* NavSystem = Cast<UNavigationSystemV1>(GetWorld()->GetNavigationSystem());
-		CheckLocation.Location = TargetLocation;
 
-		// Check if arc hit location is within the nav mesh
-		bool bIsWithinNavBounds = IsNavPointReachable(PredictResult.HitResult.Location, CheckLocation, BeamHitNavMeshTolerance);
-
-		if (bIsWithinNavBounds)
+		// Curated anchors win over the raw hit location, otherwise check if arc hit location is within the nav mesh
+		if (bSnapToTeleportAnchors && SnapToTeleportAnchor(PredictResult.HitResult.Location))
+		{
+			bIsTargetLocationValid = true;
+		}
+		else if (IsNavPointReachable(PredictResult.HitResult.Location, CheckLocation, BeamHitNavMeshTolerance) && (!bCheckPathReachability || IsPathReachable(CheckLocation)))
 		{
 			// Set Marker location
-			TargetLocation = PredictResult.HitResult.Location;
+			SimTargetLocation = PredictResult.HitResult.Location;
 			
 			// Check marker rotation
 			if (CustomMarkerRotation.Equals(FRotator::ZeroRotator))
 			{
-				TargetRotation = CustomMarkerRotation;
+				SimTargetRotation = CustomMarkerRotation;
 			}
 			else
 			{
-				TargetRotation = UKismetMathLibrary::FindLookAtRotation(TargetLocation, GetOwner()->GetActorLocation());
+				SimTargetRotation = UKismetMathLibrary::FindLookAtRotation(SimTargetLocation, GetOwner()->GetActorLocation());
 			}
-			
-			// Apply marker position and orientation
-			SetTargetMarkerLocationAndRotation(TargetLocation, TargetRotation);
 
-			// Set Target Marker Visibility
-			SetTargetMarkerVisibility(true);
 			bIsTargetLocationValid = true;
+
+			// Start streaming in textures around the target while aiming
+			if (bPreWarmDestination)
+			{
+				IStreamingManager::Get().AddViewSlaveLocation(SimTargetLocation, PreWarmTextureBoost);
+			}
+		}
+	}
+}
+
+// Draw Teleport Arc
+void URunebergVR_Teleporter::DrawTeleportArc(float Alpha)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TeleportArcDraw);
+	CSV_SCOPED_TIMING_STAT(RunebergVRTeleporter, ArcDraw);
+
+	// Show Target Marker (if a valid teleport location)
+	UpdateTargetMarker(Alpha);
+
+	// Single mesh teleport arc
+	if (bUseProceduralArcMesh)
+	{
+		ArcPoints.Reset();
+	}
+	else if (ArcSpline)
+	{
+		// Clean-up old Spline
+		ClearTeleportArc();
+	}
+
+	// Blend arc points between the last two traces, pairing points by how far along the arc they are as the point count can change
+	const bool bBlendArc = ArcSimPointsPrev.Num() > 0 && ArcSimPoints.Num() > 1;
+	for (int32 i = 0; i < ArcSimPoints.Num(); i++)
+	{
+		if (bBlendArc)
+		{
+			const FVector PrevPoint = ArcSimPointsPrev.Num() == ArcSimPoints.Num() ? ArcSimPointsPrev[i] : SampleArcAtFraction(ArcSimPointsPrev, (float)i / (ArcSimPoints.Num() - 1));
+			ArcPoints.Add(FMath::Lerp(PrevPoint, ArcSimPoints[i], Alpha));
 		}
 		else
 		{
-			// Set Target Marker Visibility
-			SetTargetMarkerVisibility(false);
-			bIsTargetLocationValid = false;
+			ArcPoints.Add(ArcSimPoints[i]);
 		}
 	}
-	else
+
+	if (bUseProceduralArcMesh)
 	{
-		// Set Target Marker Visibility
-		SetTargetMarkerVisibility(false);
-		bIsTargetLocationValid = false;
+		DrawProceduralArc();
+		return;
 	}
 
-
 	// Set the teleport arc points
 	if (ArcSpline)
 	{
-		// Clean-up old Spline
-		ClearTeleportArc();
-
 		// Set the point type for the curve
 		ArcSpline->SetSplinePointType(ArcPoints.Num() - 1, ESplinePointType::CurveClamped, true);
 
-		for (const FPredictProjectilePathPointData& PathPoint : PredictResult.PathData)
+		for (const FVector& ArcPoint : ArcPoints)
 		{
 			// Add the point to the arc spline
-			ArcPoints.Add(PathPoint.Location);
-			ArcSpline->AddSplinePoint(PathPoint.Location, ESplineCoordinateSpace::Local, true);
+			ArcSpline->AddSplinePoint(ArcPoint, ESplineCoordinateSpace::Local, true);
 		}
 	}
 
@@ -192,6 +548,7 @@ void URunebergVR_Teleporter::DrawTeleportArc()
 		{
 			// Add the arc mesh
 			USplineMeshComponent* ArcMesh = NewObject<USplineMeshComponent>(ArcSpline);
+			TELEPORT_COUNT_STAT(STAT_TeleportComponentsCreated, ComponentsCreated, 1);
 			ArcMesh->RegisterComponentWithWorld(GetWorld());
 			ArcMesh->SetMobility(EComponentMobility::Movable);
 			//ArcMesh->AttachToComponent(ArcSpline, FAttachmentTransformRules::KeepRelativeTransform);
@@ -225,6 +582,117 @@ void URunebergVR_Teleporter::ClearTeleportArc()
 	}
 
 	ArcSplineMeshes.Empty();
+
+	// Hide the procedural arc, it is kept around for the next time the arc is shown
+	if (ArcProceduralMesh)
+	{
+		ArcProceduralMesh->SetVisibility(false);
+	}
+}
+
+// Build the teleport arc as a single procedural mesh section
+void URunebergVR_Teleporter::DrawProceduralArc()
+{
+	const int32 NumPoints = ArcPoints.Num();
+	const int32 Sides = FMath::Max(ArcTubeSides, 2);
+
+	if (NumPoints < 2)
+	{
+		if (ArcProceduralMesh)
+		{
+			ArcProceduralMesh->SetVisibility(false);
+		}
+		return;
+	}
+
+	// Create the arc mesh once, arc points are in world space so it stays at the world origin
+	if (!ArcProceduralMesh)
+	{
+		ArcProceduralMesh = NewObject<UProceduralMeshComponent>(this);
+		TELEPORT_COUNT_STAT(STAT_TeleportComponentsCreated, ComponentsCreated, 1);
+		ArcProceduralMesh->SetMobility(EComponentMobility::Movable);
+		ArcProceduralMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		ArcProceduralMesh->SetCastShadow(false);
+		ArcProceduralMesh->RegisterComponentWithWorld(GetWorld());
+	}
+
+	// Side axis of the arc's (vertical) plane, shared by all rings
+	FVector ArcSide = FVector::CrossProduct(ArcPoints.Last() - ArcPoints[0], FVector::UpVector).GetSafeNormal();
+	if (ArcSide.IsNearlyZero())
+	{
+		ArcSide = GetRightVector();
+	}
+
+	// Grow the ring capacity (and rebuild the index buffer) only when the arc gets longer than ever before
+	const bool bRebuildSection = NumPoints > ArcMeshRingCapacity;
+	if (bRebuildSection)
+	{
+		ArcMeshRingCapacity = Align(NumPoints, 16);
+	}
+
+	const int32 NumVertices = ArcMeshRingCapacity * Sides;
+	ArcMeshVertices.SetNumUninitialized(NumVertices, false);
+	ArcMeshNormals.SetNumUninitialized(NumVertices, false);
+
+	// Ring vertex offsets around the arc
+	const float AngleStep = 2.f * PI / Sides;
+
+	for (int32 Ring = 0; Ring < ArcMeshRingCapacity; Ring++)
+	{
+		// Rings past the end of the arc collapse onto the last point
+		const int32 Point = FMath::Min(Ring, NumPoints - 1);
+		const FVector Tangent = (ArcPoints[FMath::Min(Point + 1, NumPoints - 1)] - ArcPoints[FMath::Max(Point - 1, 0)]).GetSafeNormal();
+		const FVector ArcUp = FVector::CrossProduct(ArcSide, Tangent).GetSafeNormal();
+		const float Radius = Ring < NumPoints ? ArcTubeRadius : 0.f;
+
+		for (int32 Side = 0; Side < Sides; Side++)
+		{
+			float SinAngle, CosAngle;
+			FMath::SinCos(&SinAngle, &CosAngle, Side * AngleStep);
+
+			const FVector Offset = ArcSide * CosAngle + ArcUp * SinAngle;
+			ArcMeshVertices[Ring * Sides + Side] = ArcPoints[Point] + Offset * Radius;
+			ArcMeshNormals[Ring * Sides + Side] = Sides > 2 ? Offset : ArcUp;
+		}
+	}
+
+	if (bRebuildSection)
+	{
+		// Quads between consecutive rings, facing out of the tube (a 2 sided ribbon faces both ways)
+		TArray<int32> Triangles;
+		TArray<FVector2D> UVs;
+		Triangles.Reserve((ArcMeshRingCapacity - 1) * Sides * 6);
+		UVs.Reserve(NumVertices);
+
+		for (int32 Ring = 0; Ring < ArcMeshRingCapacity; Ring++)
+		{
+			for (int32 Side = 0; Side < Sides; Side++)
+			{
+				UVs.Add(FVector2D((float)Side / Sides, (float)Ring / (ArcMeshRingCapacity - 1)));
+
+				if (Ring < ArcMeshRingCapacity - 1)
+				{
+					const int32 A = Ring * Sides + Side;
+					const int32 B = Ring * Sides + (Side + 1) % Sides;
+					const int32 C = A + Sides;
+					const int32 D = B + Sides;
+
+					Triangles.Add(A); Triangles.Add(B); Triangles.Add(C);
+					Triangles.Add(B); Triangles.Add(D); Triangles.Add(C);
+				}
+			}
+		}
+
+		ArcProceduralMesh->CreateMeshSection(0, ArcMeshVertices, Triangles, ArcMeshNormals, UVs, TArray<FColor>(), TArray<FProcMeshTangent>(), false);
+		ArcProceduralMesh->SetMaterial(0, ArcMaterial ? ArcMaterial : (TeleportBeamMesh ? TeleportBeamMesh->GetMaterial(0) : nullptr));
+	}
+	else
+	{
+		// Same vertex count - this is a single dynamic vertex buffer update, no new render proxy
+		ArcProceduralMesh->UpdateMeshSection(0, ArcMeshVertices, ArcMeshNormals, TArray<FVector2D>(), TArray<FColor>(), TArray<FProcMeshTangent>());
+	}
+
+	ArcProceduralMesh->SetVisibility(true);
 }
 
 // Show the teleportation arc trace
@@ -236,6 +704,7 @@ bool URunebergVR_Teleporter::ShowTeleportArc()
 		IsTeleporting = true;
 		bIsBeamTypeTeleport = true;
 		SpawnTargetMarker();
+		ResetTargetingSim();
 		return true;
 	}
 
@@ -296,9 +765,11 @@ void URunebergVR_Teleporter::ClearTeleportRay()
 	}
 }
 
-// Draw Teleport Ray
-void URunebergVR_Teleporter::DrawTeleportRay()
+// Trace the teleport ray and check the target location
+void URunebergVR_Teleporter::SimulateTeleportRay()
 {
+	SCOPE_CYCLE_COUNTER(STAT_TeleportRayTrace);
+	CSV_SCOPED_TIMING_STAT(RunebergVRTeleporter, RayTrace);
 
 	// Setup ray trace
 	FCollisionQueryParams Ray_TraceParams(FName(TEXT("Ray_Trace")), true, this->GetOwner());
@@ -309,66 +780,89 @@ void URunebergVR_Teleporter::DrawTeleportRay()
 	// Initialize Hit Result var
 	FHitResult Ray_Hit(ForceInit);
 
+	// Keep the previous result to interpolate from
+	StoreSimResult();
+
 	// Get Target Location
-	TargetLocation = FVector(this->GetComponentLocation().X + BeamLocationOffset.X,
+	SimTargetLocation = FVector(this->GetComponentLocation().X + BeamLocationOffset.X,
 		this->GetComponentLocation().Y + BeamLocationOffset.Y,
 		this->GetComponentLocation().Z + BeamLocationOffset.Z) +
 		(this->GetComponentRotation().Vector() * BeamMagnitude);
 
 	// Do the ray trace
-	bool bHit = GetWorld()->LineTraceSingleByObjectType(
-		Ray_Hit,
-		this->GetComponentLocation(),
-		FVector(this->GetComponentLocation().X + BeamLocationOffset.X,
-			this->GetComponentLocation().Y + BeamLocationOffset.Y,
-			this->GetComponentLocation().Z + BeamLocationOffset.Z) +
-			(this->GetComponentRotation().Vector() * BeamMagnitude),
-		TeleportBoundary_ObjectTypes,
-		Ray_TraceParams
-	);
+	bool bHit = false;
+	TELEPORT_COUNT_STAT(STAT_TeleportTraces, Traces, 1);
+	if (bTraceTeleportChannel)
+	{
+		// Proxy collision is simple by design
+		Ray_TraceParams.bTraceComplex = false;
+		bHit = GetWorld()->LineTraceSingleByChannel(
+			Ray_Hit,
+			this->GetComponentLocation(),
+			SimTargetLocation,
+			TeleportTraceChannel,
+			Ray_TraceParams
+		);
+	}
+	else
+	{
+		bHit = GetWorld()->LineTraceSingleByObjectType(
+			Ray_Hit,
+			this->GetComponentLocation(),
+			SimTargetLocation,
+			TeleportBoundary_ObjectTypes,
+			Ray_TraceParams
+		);
+	}
 
 
 	// Reset Target Marker
-	SetTargetMarkerVisibility(false);
 	bIsTargetLocationValid = false;
 
 	// Check if we hit a possible location to teleport to
 	if (bHit)
 	{
-		// Check if target location is within the nav mesh
 		FNavLocation tempTargetLocation;
-		UNavigationSystemV1* NavSystem = Cast<UNavigationSystemV1>(GetWorld()->GetNavigationSystem());
-		bool bIsWithinNavBounds = false;
 
-		if (NavSystem)
+		// Curated anchors win over the raw hit location, otherwise check if target location is within the nav mesh
+		if (bSnapToTeleportAnchors && SnapToTeleportAnchor(Ray_Hit.ImpactPoint))
 		{
-			bIsWithinNavBounds = NavSystem->ProjectPointToNavigation(
-				Ray_Hit.ImpactPoint,
-				tempTargetLocation,
-				BeamHitNavMeshTolerance,
-				(ANavigationData*)0, 0);
+			bIsTargetLocationValid = true;
 		}
-
-		if (bIsWithinNavBounds)
+		else if (IsNavPointReachable(Ray_Hit.ImpactPoint, tempTargetLocation, BeamHitNavMeshTolerance) && (!bCheckPathReachability || IsPathReachable(tempTargetLocation)))
 		{
 			// Set Target Marker Visibility
-			TargetLocation = Ray_Hit.ImpactPoint;
+			SimTargetLocation = Ray_Hit.ImpactPoint;
 			
 			// Check marker rotation
 			if (CustomMarkerRotation.Equals(FRotator::ZeroRotator))
 			{
-				TargetRotation = CustomMarkerRotation;
+				SimTargetRotation = CustomMarkerRotation;
 			}
 			else
 			{
-				TargetRotation = UKismetMathLibrary::FindLookAtRotation(TargetLocation, GetOwner()->GetActorLocation());
+				SimTargetRotation = UKismetMathLibrary::FindLookAtRotation(SimTargetLocation, GetOwner()->GetActorLocation());
 			}
 
-			SetTargetMarkerLocationAndRotation(TargetLocation, TargetRotation);
-			SetTargetMarkerVisibility(true);
 			bIsTargetLocationValid = true;
+
+			// Start streaming in textures around the target while aiming
+			if (bPreWarmDestination)
+			{
+				IStreamingManager::Get().AddViewSlaveLocation(SimTargetLocation, PreWarmTextureBoost);
+			}
 		}
 	}
+}
+
+// Draw Teleport Ray
+void URunebergVR_Teleporter::DrawTeleportRay(float Alpha)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TeleportRayDraw);
+	CSV_SCOPED_TIMING_STAT(RunebergVRTeleporter, RayDraw);
+
+	// Show Target Marker (if a valid teleport location)
+	UpdateTargetMarker(Alpha);
 
 	// Draw ray mesh
 	ClearTeleportRay();
@@ -376,6 +870,7 @@ void URunebergVR_Teleporter::DrawTeleportRay()
 	{
 		// Spawn the beam mesh
 		RayMesh = NewObject<UStaticMeshComponent>(this);
+		TELEPORT_COUNT_STAT(STAT_TeleportComponentsCreated, ComponentsCreated, 1);
 		RayMesh->RegisterComponentWithWorld(GetWorld());
 		RayMesh->SetMobility(EComponentMobility::Movable);
 		RayMesh->AttachToComponent(this, FAttachmentTransformRules::KeepRelativeTransform);
@@ -426,6 +921,7 @@ bool URunebergVR_Teleporter::ShowTeleportRay()
 		IsTeleporting = true;
 		bIsBeamTypeTeleport = true;
 		SpawnTargetMarker();
+		ResetTargetingSim();
 		RayNumOfTimesToScale_Actual = 0.f;
 
 		return true;
@@ -445,15 +941,15 @@ bool URunebergVR_Teleporter::TeleportNow(FWorldFadeSettings FadeOutOptions, FWor
 		FVector HMDLocation;
 		UHeadMountedDisplayFunctionLibrary::GetOrientationAndPosition(HMDRotation, HMDLocation);
 
-		// Calculate target location
-		if (TargetParticleSystemComponent)
+		// Calculate target location - the simulated target, not the (interpolated, pooled) marker, plus the marker's spawn offset
+		TeleportTargetLoc = SimTargetLocation;
+		if (TeleportTargetMesh && TargetStaticMeshComponent)
 		{
-			TeleportTargetLoc = TargetParticleSystemComponent->GetComponentTransform().GetLocation();
+			TeleportTargetLoc += TeleportTargetMeshSpawnOffset;
 		}
-
-		if (TeleportTargetMesh)
+		else if (TargetParticleSystemComponent)
 		{
-			TeleportTargetLoc = TargetStaticMeshComponent->GetComponentTransform().GetLocation();
+			TeleportTargetLoc += TeleportTargetParticleSpawnOffset;
 		}
 
 		// Setup camera offsets
@@ -479,6 +975,12 @@ bool URunebergVR_Teleporter::TeleportNow(FWorldFadeSettings FadeOutOptions, FWor
 		//UE_LOG(LogTemp, Warning, TEXT("[TELEPORT] Current Camera Relative Location: %s"), *PawnCamera->GetRelativeTransform().GetLocation().ToString());
 		//UE_LOG(LogTemp, Warning, TEXT("[TELEPORT] Unadjusted Target Location is: %s"), *TeleportTargetLoc.ToString());
 
+		// Start loading the destination while the world fades out
+		if (bPreWarmDestination)
+		{
+			StartPreWarm(TeleportTargetLoc);
+		}
+
 		// Set target location adjustments
 		TeleportTargetLoc = FVector(TeleportTargetLoc.X - TeleportCameraOffset.X, TeleportTargetLoc.Y - TeleportCameraOffset.Y, TeleportTargetLoc.Z);
 		TeleportTargetLoc = FVector(TeleportTargetLoc.X + PawnHeightOffset.X + TeleportTargetPawnSpawnOffset.X,
@@ -508,8 +1010,7 @@ bool URunebergVR_Teleporter::TeleportNow(FWorldFadeSettings FadeOutOptions, FWor
 			else if (FadeOutTeleportOffset < 0.f)
 			{
 				// Immediately teleport
-				this->GetOwner()->SetActorLocation(TeleportTargetLoc, false, nullptr, TeleportPhysics ? ETeleportType::TeleportPhysics : ETeleportType::None);
-
+				OnTeleport();
 			}
 			else
 			{
@@ -524,11 +1025,15 @@ bool URunebergVR_Teleporter::TeleportNow(FWorldFadeSettings FadeOutOptions, FWor
 		else 
 		{
 			// No effective fade out, instantly teleport pawn
-			this->GetOwner()->SetActorLocation(TeleportTargetLoc, false, nullptr, TeleportPhysics ? ETeleportType::TeleportPhysics : ETeleportType::None);
+			OnTeleport();
 		}
 
-		// Check if we need to fade in
-		if (FadeInOptions.bDoWorldFade)
+		// Check if we need to fade in - when pre-warming, fade in once the pawn is at a loaded destination
+		if (bIsPreWarming)
+		{
+			PendingFadeIn = FadeInOptions;
+		}
+		else if (FadeInOptions.bDoWorldFade)
 		{
 			// Start fade in
 			UGameplayStatics::GetPlayerCameraManager(GetWorld(), 0)->StartCameraFade(FadeInOptions.FromOpacity, FadeInOptions.ToOpacity, FadeInOptions.FadeDuration,
@@ -568,11 +1073,103 @@ bool URunebergVR_Teleporter::TeleportNow(FWorldFadeSettings FadeOutOptions, FWor
 
 void URunebergVR_Teleporter::OnTeleport() 
 {
+	// Hold the teleport until the destination is streamed in or we run out of time
+	if (bIsPreWarming && !IsDestinationResident() && GetWorld()->GetTimeSeconds() - PreWarmStartTime < PreWarmTimeout)
+	{
+		GetWorld()->GetTimerManager().SetTimer(FadeTimerHandle, this, &URunebergVR_Teleporter::OnTeleport, 0.05f, false);
+		return;
+	}
+
 	// Teleport Pawn
 	this->GetOwner()->SetActorLocation(TeleportTargetLoc, false, nullptr, TeleportTargetPhys ? ETeleportType::TeleportPhysics : ETeleportType::None);
+
+	// Replicated VR movement would otherwise be corrected back to where the server last had the pawn
+	URunebergVR_Movement* Movement = GetOwner()->FindComponentByClass<URunebergVR_Movement>();
+	if (Movement)
+	{
+		Movement->NotifyPawnTeleported();
+	}
 	
 	// Clear Fade Timer Handle
 	GetWorld()->GetTimerManager().ClearTimer(FadeTimerHandle);
+
+	// Pawn is at the destination, let level streaming take over and fade back in
+	if (bIsPreWarming)
+	{
+		EndPreWarm();
+
+		if (PendingFadeIn.bDoWorldFade)
+		{
+			UGameplayStatics::GetPlayerCameraManager(GetWorld(), 0)->StartCameraFade(PendingFadeIn.FromOpacity, PendingFadeIn.ToOpacity, PendingFadeIn.FadeDuration,
+				PendingFadeIn.FadeColor, PendingFadeIn.bShouldFadeAudio, false);
+		}
+	}
+}
+
+// Start streaming in levels and textures around the teleport destination
+void URunebergVR_Teleporter::StartPreWarm(const FVector& Destination)
+{
+	UWorld* World = GetWorld();
+	PreWarmLevels.Empty();
+	PendingFadeIn = FWorldFadeSettings();
+
+	// Load levels whose streaming volumes contain the destination
+	for (ULevelStreaming* StreamingLevel : World->GetStreamingLevels())
+	{
+		if (!StreamingLevel || StreamingLevel->bDisableDistanceStreaming)
+		{
+			continue;
+		}
+
+		for (ALevelStreamingVolume* StreamingVolume : StreamingLevel->EditorStreamingVolumes)
+		{
+			if (StreamingVolume && !StreamingVolume->bDisabled && StreamingVolume->EncompassesPoint(Destination))
+			{
+				StreamingLevel->SetShouldBeLoaded(true);
+				StreamingLevel->SetShouldBeVisible(StreamingVolume->StreamingUsage != SVB_Loading && StreamingVolume->StreamingUsage != SVB_LoadingNotVisible);
+				PreWarmLevels.Add(StreamingLevel);
+				break;
+			}
+		}
+	}
+
+	// Pause streaming volume updates so the current view doesn't unload them again before the pawn gets there
+	if (PreWarmLevels.Num() > 0)
+	{
+		World->DelayStreamingVolumeUpdates(INDEX_NONE);
+	}
+
+	// Textures (and HLOD proxies) around the destination
+	IStreamingManager::Get().AddViewSlaveLocation(Destination, PreWarmTextureBoost, false, PreWarmTimeout);
+
+	PreWarmStartTime = World->GetTimeSeconds();
+	bIsPreWarming = true;
+}
+
+// Check if everything requested by StartPreWarm is loaded and visible
+bool URunebergVR_Teleporter::IsDestinationResident() const
+{
+	for (const TWeakObjectPtr<ULevelStreaming>& StreamingLevel : PreWarmLevels)
+	{
+		if (StreamingLevel.IsValid() && (!StreamingLevel->IsLevelLoaded() || (StreamingLevel->GetShouldBeVisibleFlag() && !StreamingLevel->IsLevelVisible())))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Resume normal level streaming after a pre-warmed teleport
+void URunebergVR_Teleporter::EndPreWarm()
+{
+	if (PreWarmLevels.Num() > 0)
+	{
+		GetWorld()->DelayStreamingVolumeUpdates(0);
+	}
+
+	PreWarmLevels.Empty();
+	bIsPreWarming = false;
 }
 
 // Show the teleport target marker
@@ -611,6 +1208,10 @@ bool URunebergVR_Teleporter::ShowMarker()
 		TargetRotation = UKismetMathLibrary::FindLookAtRotation(TargetLocation, GetOwner()->GetActorLocation());
 		TargetLocation.Z = FloorIsAtZ;
 
+		// No simulation runs in this mode, the marker location is the teleport target
+		SimTargetLocation = SimTargetLocationPrev = TargetLocation;
+		SimTargetRotation = SimTargetRotationPrev = TargetRotation;
+
 		// Calculate Rotation of marker to face player and set the new transform
 		SetTargetMarkerLocationAndRotation(TargetLocation, TargetRotation);
 
@@ -694,34 +1295,59 @@ bool URunebergVR_Teleporter::MoveMarker(EMoveDirectionEnum MarkerDirection, int
 			break;
 		}
 
+		// The moved marker is the teleport target
+		SimTargetLocation = SimTargetLocationPrev = TargetLocation;
+		SimTargetRotation = SimTargetRotationPrev = TargetRotation;
+
 		return true;
 	}
 
 	return false;
 }
 
-// Show target location marker
+// Show target location marker - marker components are created once and reused every time the marker is shown
 void URunebergVR_Teleporter::SpawnTargetMarker(FVector MarkerLocation, FRotator MarkerRotation)
 {
 	// Activate Particle System if available
 	if (TeleportTargetParticle) {
-		TargetParticleSystemComponent = UGameplayStatics::SpawnEmitterAtLocation(this, TeleportTargetParticle, MarkerLocation, MarkerRotation);
+		if (!TargetParticleSystemComponent)
+		{
+			TargetParticleSystemComponent = NewObject<UParticleSystemComponent>(this);
+			TELEPORT_COUNT_STAT(STAT_TeleportComponentsCreated, ComponentsCreated, 1);
+			TargetParticleSystemComponent->bAutoActivate = false;
+			TargetParticleSystemComponent->bAutoDestroy = false;
+			TargetParticleSystemComponent->SetMobility(EComponentMobility::Movable);
+			TargetParticleSystemComponent->RegisterComponentWithWorld(GetWorld());
+		}
+
+		if (TargetParticleSystemComponent->Template != TeleportTargetParticle)
+		{
+			TargetParticleSystemComponent->SetTemplate(TeleportTargetParticle);
+		}
+
+		TargetParticleSystemComponent->SetWorldLocationAndRotation(MarkerLocation, MarkerRotation);
 		TargetParticleSystemComponent->SetWorldScale3D(TeleportTargetParticleScale);
 		TargetParticleSystemComponent->SetVisibility(false);
-		TargetParticleSystemComponent->SetMobility(EComponentMobility::Movable);
+
+		// Restart the effect from scratch on the existing emitter
+		TargetParticleSystemComponent->ActivateSystem(true);
 
 		//UE_LOG(LogTemp, Warning, TEXT("[TELEPORT] Current Particle Marker Transform is: %s"), *TargetParticleSystemComponent->GetComponentTransform().ToString());
 	}
 
 	// Show Static Mesh if available
 	if (TeleportTargetMesh) {
-		// Create new static mesh component and attach to actor
-		TargetStaticMeshComponent = NewObject<UStaticMeshComponent>(this);
-		TargetStaticMeshComponent->RegisterComponentWithWorld(GetWorld());
-		TargetStaticMeshComponent->SetSimulatePhysics(false);
-		TargetStaticMeshComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		TargetStaticMeshComponent->SetMobility(EComponentMobility::Movable);
-		TargetStaticMeshComponent->AttachToComponent(GetOwner()->GetRootComponent(), FAttachmentTransformRules::KeepRelativeTransform);
+		if (!TargetStaticMeshComponent)
+		{
+			// Create new static mesh component and attach to actor
+			TargetStaticMeshComponent = NewObject<UStaticMeshComponent>(this);
+			TELEPORT_COUNT_STAT(STAT_TeleportComponentsCreated, ComponentsCreated, 1);
+			TargetStaticMeshComponent->RegisterComponentWithWorld(GetWorld());
+			TargetStaticMeshComponent->SetSimulatePhysics(false);
+			TargetStaticMeshComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+			TargetStaticMeshComponent->SetMobility(EComponentMobility::Movable);
+			TargetStaticMeshComponent->AttachToComponent(GetOwner()->GetRootComponent(), FAttachmentTransformRules::KeepRelativeTransform);
+		}
 
 		//Set Mesh
 		TargetStaticMeshComponent->SetVisibility(false);
@@ -732,19 +1358,18 @@ void URunebergVR_Teleporter::SpawnTargetMarker(FVector MarkerLocation, FRotator
 	}
 }
 
-// Remove target location marker
+// Remove target location marker - markers are hidden and kept for the next time the marker is shown
 void URunebergVR_Teleporter::RemoveTargetMarker()
 {
-	// Destroy Particle System if available
+	// Stop Particle System if available
 	if (TargetParticleSystemComponent) {
-		TargetParticleSystemComponent->DestroyComponent();
-		TargetParticleSystemComponent = nullptr;
+		TargetParticleSystemComponent->SetVisibility(false);
+		TargetParticleSystemComponent->DeactivateSystem();
 	}
 
-	// Destroy Static Mesh if available
+	// Hide Static Mesh if available
 	if (TargetStaticMeshComponent) {
-		TargetStaticMeshComponent->DestroyComponent();
-		TargetStaticMeshComponent = nullptr;
+		TargetStaticMeshComponent->SetVisibility(false);
 	}
 
 	bIsTargetLocationValid = false;
@@ -780,3 +1405,119 @@ void  URunebergVR_Teleporter::SetTargetMarkerLocationAndRotation(FVector MarkerL
 		TargetStaticMeshComponent->SetWorldRotation(MarkerRotation);
 	}
 }
+
+// Add simple box collision over the walkable surfaces of a static mesh
+int32 URunebergVR_Teleporter::GenerateTeleportProxyCollision(UStaticMeshComponent* MeshComponent, TEnumAsByte<ECollisionChannel> TraceChannel, float MaxFloorAngle, float CellSize, float HeightTolerance)
+{
+	UStaticMesh* StaticMesh = MeshComponent ? MeshComponent->GetStaticMesh() : nullptr;
+	AActor* Owner = MeshComponent ? MeshComponent->GetOwner() : nullptr;
+	if (!StaticMesh || !Owner || !StaticMesh->RenderData.IsValid() || StaticMesh->RenderData->LODResources.Num() < 1 || CellSize < 1.f || HeightTolerance < 0.1f)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[TELEPORT PROXY] No static mesh data or invalid cell settings, no proxy collision generated."));
+		return 0;
+	}
+
+	// Work in the mesh's local space, the boxes are attached to it
+	const FStaticMeshLODResources& LOD = StaticMesh->RenderData->LODResources[0];
+	const FPositionVertexBuffer& Positions = LOD.VertexBuffers.PositionVertexBuffer;
+	FIndexArrayView Indices = LOD.IndexBuffer.GetArrayView();
+	const float MinFloorNormalZ = FMath::Cos(FMath::DegreesToRadians(MaxFloorAngle));
+	const FVector MeshScale = MeshComponent->GetComponentScale();
+
+	// Highest floor point per cell, keyed by cell X/Y and height band
+	TMap<FIntVector, float> FloorCells;
+	for (int32 i = 0; i + 2 < Indices.Num(); i += 3)
+	{
+		const FVector A = Positions.VertexPosition(Indices[i]);
+		const FVector B = Positions.VertexPosition(Indices[i + 1]);
+		const FVector C = Positions.VertexPosition(Indices[i + 2]);
+
+		// Only upward facing triangles are floors, judged with the component scale applied
+		const FVector Normal = FVector::CrossProduct((C - A) * MeshScale, (B - A) * MeshScale).GetSafeNormal();
+		if (Normal.Z < MinFloorNormalZ)
+		{
+			continue;
+		}
+
+		// Mark every cell whose center is covered by the triangle
+		const FBox TriangleBounds(TArray<FVector>({ A, B, C }));
+		const int32 MinX = FMath::FloorToInt(TriangleBounds.Min.X / CellSize);
+		const int32 MaxX = FMath::FloorToInt(TriangleBounds.Max.X / CellSize);
+		const int32 MinY = FMath::FloorToInt(TriangleBounds.Min.Y / CellSize);
+		const int32 MaxY = FMath::FloorToInt(TriangleBounds.Max.Y / CellSize);
+		for (int32 X = MinX; X <= MaxX; X++)
+		{
+			for (int32 Y = MinY; Y <= MaxY; Y++)
+			{
+				const FVector CellCenter((X + 0.5f) * CellSize, (Y + 0.5f) * CellSize, 0.f);
+				const FVector Bary = FMath::GetBaryCentric2D(CellCenter, FVector(A.X, A.Y, 0.f), FVector(B.X, B.Y, 0.f), FVector(C.X, C.Y, 0.f));
+				if (Bary.X < 0.f || Bary.Y < 0.f || Bary.Z < 0.f)
+				{
+					continue;
+				}
+
+				const float FloorZ = A.Z * Bary.X + B.Z * Bary.Y + C.Z * Bary.Z;
+				const FIntVector Cell(X, Y, FMath::FloorToInt(FloorZ / HeightTolerance));
+				if (float* CellZ = FloorCells.Find(Cell))
+				{
+					*CellZ = FMath::Max(*CellZ, FloorZ);
+				}
+				else
+				{
+					FloorCells.Add(Cell, FloorZ);
+				}
+			}
+		}
+	}
+
+	// Merge runs of neighbouring cells along X into a single box
+	FloorCells.KeySort([](const FIntVector& L, const FIntVector& R)
+	{
+		return L.Z != R.Z ? L.Z < R.Z : (L.Y != R.Y ? L.Y < R.Y : L.X < R.X);
+	});
+
+	const float BoxHalfHeight = 2.f;
+	int32 BoxCount = 0;
+	TArray<FIntVector> Keys;
+	FloorCells.GetKeys(Keys);
+
+#if WITH_EDITOR
+	// One undo step for all of the boxes
+	FScopedTransaction Transaction(NSLOCTEXT("RunebergVR", "GenerateTeleportProxyCollision", "Generate Teleport Proxy Collision"));
+	Owner->Modify();
+	MeshComponent->Modify();
+#endif
+
+	for (int32 RunStart = 0; RunStart < Keys.Num(); )
+	{
+		int32 RunEnd = RunStart;
+		float RunZ = FloorCells[Keys[RunStart]];
+		while (RunEnd + 1 < Keys.Num() && Keys[RunEnd + 1] == Keys[RunEnd] + FIntVector(1, 0, 0))
+		{
+			RunEnd++;
+			RunZ = FMath::Max(RunZ, FloorCells[Keys[RunEnd]]);
+		}
+
+		// Box top sits on the floor so the beam lands on the surface
+		const float RunLength = (RunEnd - RunStart + 1) * CellSize;
+		const FVector BoxCenter(Keys[RunStart].X * CellSize + RunLength * 0.5f, (Keys[RunStart].Y + 0.5f) * CellSize, RunZ - BoxHalfHeight);
+
+		UBoxComponent* ProxyBox = NewObject<UBoxComponent>(Owner, NAME_None, RF_Transactional);
+		ProxyBox->SetupAttachment(MeshComponent);
+		ProxyBox->SetRelativeLocation(BoxCenter);
+		ProxyBox->SetBoxExtent(FVector(RunLength * 0.5f, CellSize * 0.5f, BoxHalfHeight), false);
+		ProxyBox->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+		ProxyBox->SetCollisionResponseToAllChannels(ECR_Ignore);
+		ProxyBox->SetCollisionResponseToChannel(TraceChannel, ECR_Block);
+		ProxyBox->SetGenerateOverlapEvents(false);
+		ProxyBox->SetCanEverAffectNavigation(false);
+		ProxyBox->SetHiddenInGame(true);
+		Owner->AddInstanceComponent(ProxyBox);
+		ProxyBox->RegisterComponent();
+
+		BoxCount++;
+		RunStart = RunEnd + 1;
+	}
+
+	return BoxCount;
+}
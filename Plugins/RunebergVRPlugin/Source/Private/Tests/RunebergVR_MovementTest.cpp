@@ -0,0 +1,52 @@
+// Copyright (C) 2017 Runeberg (github: 1runeberg, UE4 Forums: runeberg)
+
+/*
+The MIT License (MIT)
+Copyright (c) 2017 runeberg (github: 1runeberg, UE4 Forums: runeberg)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "RunebergVR_Movement.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRunebergVRPlayAreaConversionTest, "RunebergVR.Movement.PlayAreaConversion", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// A chaperone play area rect converted to tracking space and set as the play area, no headset or world needed
+bool FRunebergVRPlayAreaConversionTest::RunTest(const FString& Parameters)
+{
+	// 2m wide (X), 3m deep (Z) play area in OpenVR space, going around the rect
+	TArray<FVector> Corners;
+	Corners.Add(FVector(-1.f, 0.f, -1.5f));
+	Corners.Add(FVector(1.f, 0.f, -1.5f));
+	Corners.Add(FVector(1.f, 0.f, 1.5f));
+	Corners.Add(FVector(-1.f, 0.f, 1.5f));
+
+	// OpenVR -Z is forward (unreal X), OpenVR X is right (unreal Y)
+	const TArray<FVector2D> Points = URunebergVR_Movement::ChaperoneToPlayAreaPolygon(Corners, 100.f);
+	TestEqual(TEXT("Corner count"), Points.Num(), 4);
+	if (Points.Num() != 4)
+	{
+		return false;
+	}
+	TestTrue(TEXT("First corner"), Points[0].Equals(FVector2D(150.f, -100.f)));
+	TestTrue(TEXT("Third corner"), Points[2].Equals(FVector2D(-150.f, 100.f)));
+
+	URunebergVR_Movement* Movement = NewObject<URunebergVR_Movement>();
+	Movement->SetPlayAreaPolygon(Points);
+
+	TestEqual(TEXT("Center is 1m from the side edges"), Movement->GetDistanceToPlayAreaEdge(FVector2D::ZeroVector), 100.f, KINDA_SMALL_NUMBER);
+	TestEqual(TEXT("Near the front edge"), Movement->GetDistanceToPlayAreaEdge(FVector2D(140.f, 0.f)), 10.f, KINDA_SMALL_NUMBER);
+	TestEqual(TEXT("Outside to the right"), Movement->GetDistanceToPlayAreaEdge(FVector2D(0.f, 150.f)), -50.f, KINDA_SMALL_NUMBER);
+	TestEqual(TEXT("Outside past a corner"), Movement->GetDistanceToPlayAreaEdge(FVector2D(190.f, 130.f)), -50.f, KINDA_SMALL_NUMBER);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
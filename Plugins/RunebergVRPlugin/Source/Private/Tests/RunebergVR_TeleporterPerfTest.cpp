@@ -0,0 +1,242 @@
+// Copyright (C) 2017 Runeberg (github: 1runeberg, UE4 Forums: runeberg)
+
+/*
+The MIT License (MIT)
+Copyright (c) 2017 runeberg (github: 1runeberg, UE4 Forums: runeberg)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "RunebergVR_Teleporter.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/PlatformTime.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "GameFramework/WorldSettings.h"
+#include "Components/BrushComponent.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "GameFramework/Pawn.h"
+#include "NavMesh/NavMeshBoundsVolume.h"
+#include "NavMesh/RecastNavMesh.h"
+#include "NavigationSystem.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace RunebergVRTeleporterPerf
+{
+	// Test level - a floor covered in box obstacles, all of it on the nav mesh
+	const float FloorSize = 8000.f;
+	const int32 ObstaclesPerSide = 16;
+
+	// Frames captured per case at a fixed 90Hz step
+	const int32 NumFrames = 600;
+	const float DeltaTime = 1.f / 90.f;
+
+	// Teleporter setups to compare
+	struct FCase
+	{
+		const TCHAR* Name;
+		int32 Mode;
+		bool bProceduralArc;
+		bool bAdaptiveArc;
+	};
+
+	const FCase Cases[] =
+	{
+		{ TEXT("ArcSpline"), 0, false, false },
+		{ TEXT("ArcProcedural"), 0, true, false },
+		{ TEXT("ArcProceduralAdaptive"), 0, true, true },
+		{ TEXT("Ray"), 1, false, false },
+	};
+
+	// Scripted controller aim - a yaw sweep with the pitch bobbing up and down, the same every run and needs no HMD
+	FRotator GetAimRotation(int32 Frame)
+	{
+		const float Time = Frame * DeltaTime;
+		return FRotator(-30.f + 20.f * FMath::Sin(Time * 1.3f), Time * 40.f, 0.f);
+	}
+
+	// Spawn a movable box so its mesh can be set after spawning
+	void SpawnBox(UWorld* World, UStaticMesh* Cube, const FVector& Location, const FVector& Scale)
+	{
+		AStaticMeshActor* Box = World->SpawnActor<AStaticMeshActor>(Location, FRotator::ZeroRotator);
+		Box->SetMobility(EComponentMobility::Movable);
+		Box->GetStaticMeshComponent()->SetStaticMesh(Cube);
+		Box->SetActorScale3D(Scale);
+	}
+
+	// Build the test level in a fresh game world and bake its nav mesh
+	UWorld* CreateTestWorld(UStaticMesh* Cube)
+	{
+		UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+		FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+		WorldContext.SetCurrentWorld(World);
+
+		// No game instance or game mode, begin play straight from the world settings
+		FNavigationSystem::AddNavigationSystemToWorld(*World, FNavigationSystemRunMode::GameMode);
+		World->InitializeActorsForPlay(FURL());
+		World->GetWorldSettings()->NotifyBeginPlay();
+
+		// Engine cube is 100 units across
+		SpawnBox(World, Cube, FVector(0.f, 0.f, -50.f), FVector(FloorSize / 100.f, FloorSize / 100.f, 1.f));
+
+		const float Spacing = FloorSize / ObstaclesPerSide;
+		for (int32 X = 0; X < ObstaclesPerSide; X++)
+		{
+			for (int32 Y = 0; Y < ObstaclesPerSide; Y++)
+			{
+				// Leave the middle clear for the pawn
+				const FVector Location((X + 0.5f) * Spacing - FloorSize / 2.f, (Y + 0.5f) * Spacing - FloorSize / 2.f, 0.f);
+				if (Location.Size2D() > Spacing)
+				{
+					const float Height = 50.f + ((X * 7 + Y * 13) % 5) * 50.f;
+					SpawnBox(World, Cube, Location + FVector(0.f, 0.f, Height / 2.f), FVector(1.5f, 1.5f, Height / 100.f));
+				}
+			}
+		}
+
+		// Nav bounds over the whole floor, the volume takes its bounds from a box body instead of a brush
+		ANavMeshBoundsVolume* NavBounds = World->SpawnActor<ANavMeshBoundsVolume>(FVector::ZeroVector, FRotator::ZeroRotator);
+		UBrushComponent* NavBoundsBrush = NavBounds->GetBrushComponent();
+		NavBoundsBrush->BrushBodySetup = NewObject<UBodySetup>(NavBoundsBrush);
+		NavBoundsBrush->BrushBodySetup->AggGeom.BoxElems.Add(FKBoxElem(FloorSize, FloorSize, 1000.f));
+		NavBoundsBrush->UpdateBounds();
+
+		UNavigationSystemV1* NavSystem = FNavigationSystem::GetCurrent<UNavigationSystemV1>(World);
+		if (NavSystem)
+		{
+			NavSystem->OnNavigationBoundsUpdated(NavBounds);
+			NavSystem->Build();
+		}
+
+		return World;
+	}
+
+	void DestroyTestWorld(UWorld* World)
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRunebergVRTeleporterPerfTest, "RunebergVR.Teleporter.Perf", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter | EAutomationTestFlags::PerfFilter)
+
+// Drive the teleporter along a scripted aim path in each targeting mode and write time per tick, traces and component allocations to a csv
+bool FRunebergVRTeleporterPerfTest::RunTest(const FString& Parameters)
+{
+	using namespace RunebergVRTeleporterPerf;
+
+	UStaticMesh* Cube = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+	UStaticMesh* Cylinder = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cylinder.Cylinder"));
+	if (!Cube || !Cylinder)
+	{
+		AddError(TEXT("Engine basic shapes are missing"));
+		return false;
+	}
+
+	// A game world only builds nav mesh at runtime if the nav mesh allows it
+	ARecastNavMesh* NavMeshDefaults = GetMutableDefault<ARecastNavMesh>();
+	UEnumProperty* RuntimeGenerationProperty = FindField<UEnumProperty>(ANavigationData::StaticClass(), TEXT("RuntimeGeneration"));
+	void* RuntimeGenerationValue = RuntimeGenerationProperty ? RuntimeGenerationProperty->ContainerPtrToValuePtr<void>(NavMeshDefaults) : nullptr;
+	int64 OldRuntimeGeneration = 0;
+	if (RuntimeGenerationValue)
+	{
+		OldRuntimeGeneration = RuntimeGenerationProperty->GetUnderlyingProperty()->GetSignedIntPropertyValue(RuntimeGenerationValue);
+		RuntimeGenerationProperty->GetUnderlyingProperty()->SetIntPropertyValue(RuntimeGenerationValue, (int64)ERuntimeGenerationType::Dynamic);
+	}
+
+	UWorld* World = CreateTestWorld(Cube);
+
+	if (RuntimeGenerationValue)
+	{
+		RuntimeGenerationProperty->GetUnderlyingProperty()->SetIntPropertyValue(RuntimeGenerationValue, OldRuntimeGeneration);
+	}
+
+	FString Csv = TEXT("Case,Frame,TickMs,Traces,NavQueries,ComponentsCreated\n");
+
+	for (const FCase& Case : Cases)
+	{
+		// Standing pawn in the clearing, the teleporter stands in for a motion controller at hand height
+		APawn* Pawn = World->SpawnActor<APawn>(FVector(0.f, 0.f, 100.f), FRotator::ZeroRotator);
+		USceneComponent* PawnRoot = NewObject<USceneComponent>(Pawn);
+		Pawn->SetRootComponent(PawnRoot);
+		PawnRoot->RegisterComponent();
+
+		URunebergVR_Teleporter* Teleporter = NewObject<URunebergVR_Teleporter>(Pawn);
+		Teleporter->TeleportBeamMesh = Cylinder;
+		Teleporter->TeleportTargetMesh = Cube;
+		Teleporter->bUseProceduralArcMesh = Case.bProceduralArc;
+		Teleporter->bAdaptiveArcResolution = Case.bAdaptiveArc;
+		Teleporter->bCheckPathReachability = true;
+		Teleporter->SetupAttachment(PawnRoot);
+		Teleporter->SetRelativeLocation(FVector(20.f, 20.f, 0.f));
+		Teleporter->RegisterComponent();
+
+		// Ticked by hand below so only the teleporter's own work is timed
+		Teleporter->SetComponentTickEnabled(false);
+
+		if (Case.Mode == 0)
+		{
+			Teleporter->ShowTeleportArc();
+		}
+		else
+		{
+			Teleporter->ShowTeleportRay();
+		}
+
+		const FRunebergVRTeleporterCounters StartCounters = Teleporter->GetPerfCounters();
+		FRunebergVRTeleporterCounters LastCounters = StartCounters;
+		double TotalTickTime = 0.0;
+		double MaxTickTime = 0.0;
+
+		for (int32 Frame = 0; Frame < NumFrames; Frame++)
+		{
+			Teleporter->SetWorldRotation(GetAimRotation(Frame));
+
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+			Teleporter->TickComponent(DeltaTime, LEVELTICK_All, &Teleporter->PrimaryComponentTick);
+			const double TickTime = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+
+			TotalTickTime += TickTime;
+			MaxTickTime = FMath::Max(MaxTickTime, TickTime);
+
+			const FRunebergVRTeleporterCounters& Counters = Teleporter->GetPerfCounters();
+			Csv += FString::Printf(TEXT("%s,%d,%.4f,%u,%u,%u\n"), Case.Name, Frame, TickTime,
+				Counters.Traces - LastCounters.Traces, Counters.NavQueries - LastCounters.NavQueries, Counters.ComponentsCreated - LastCounters.ComponentsCreated);
+			LastCounters = Counters;
+
+			// Let the world run so async path queries come back
+			World->Tick(LEVELTICK_All, DeltaTime);
+		}
+
+		const float CaptureTime = NumFrames * DeltaTime;
+		AddInfo(FString::Printf(TEXT("%s: %.3f ms avg, %.3f ms max per tick, %.1f traces per tick, %.1f components created per sec"), Case.Name,
+			TotalTickTime / NumFrames, MaxTickTime, (float)(LastCounters.Traces - StartCounters.Traces) / NumFrames,
+			(LastCounters.ComponentsCreated - StartCounters.ComponentsCreated) / CaptureTime));
+
+		Pawn->Destroy();
+	}
+
+	DestroyTestWorld(World);
+
+	// One file per run so runs can be compared across commits
+	const FString CsvPath = FPaths::ProfilingDir() / TEXT("RunebergVR") / FString::Printf(TEXT("TeleporterPerf-%s.csv"), *FDateTime::Now().ToString());
+	if (!FFileHelper::SaveStringToFile(Csv, *CsvPath))
+	{
+		AddError(FString::Printf(TEXT("Couldn't write %s"), *CsvPath));
+		return false;
+	}
+
+	AddInfo(FString::Printf(TEXT("Wrote %s"), *CsvPath));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -10,6 +10,10 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 #pragma once
 #include "Modules/ModuleManager.h"
+#include "Stats/Stats.h"
+
+// Stat group for the plugin's components (stat RunebergVR)
+DECLARE_STATS_GROUP(TEXT("RunebergVR"), STATGROUP_RunebergVR, STATCAT_Advanced);
 
 class FRunebergVRPluginModule : public IModuleInterface
 {
@@ -18,4 +22,7 @@ public:
 	/** IModuleInterface implementation */
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
+
+private:
+	FDelegateHandle WorldCleanupHandle;
 };
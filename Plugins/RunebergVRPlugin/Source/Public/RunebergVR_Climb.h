@@ -29,10 +29,13 @@ public:
 	URunebergVR_Climb();
 
 public:	
+	// Called when the game starts
+	virtual void BeginPlay() override;
+
 	// Called every frame
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
-	// Tags that can be used to stop gravity
+	// Tags that can be used to stop gravity, read when the game starts
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
 	TArray<FName> ClimbTags;
 
@@ -58,4 +61,7 @@ public:
 
 private:
 	void StartClimb(USceneComponent* ClimbingReference);
+
+	// Climb tags as a set for tag lookups, built when the game starts
+	TSet<FName> ClimbTagSet;
 };
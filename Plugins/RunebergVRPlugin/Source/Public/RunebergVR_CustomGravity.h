@@ -15,6 +15,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 #include "Components/ActorComponent.h"
 #include "Engine.h"
+#include "RunebergVR_FixedTimestep.h"
 #include "RunebergVR_CustomGravity.generated.h"
 
 UENUM(BlueprintType)		
@@ -39,6 +40,9 @@ public:
 	URunebergVR_CustomGravity();
 
 public:	
+	// Called when the game starts
+	virtual void BeginPlay() override;
+
 	// Called every frame
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
@@ -50,15 +54,19 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
 	float GravityStrength = 1.0f;
 
+	/** Rate (Hz) to simulate gravity at, the actor is drawn between steps. Gravity keeps its per frame feel at 90 fps. 0 steps once per frame */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
+	float FixedStepRate = 0.f;
+
 	// Gravity origin when gravity direction is set to RELATIVE
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
 	FVector GravityOrigin = FVector::ZeroVector;
 
-	// Tags that can be used to stop gravity
+	// Tags that can be used to stop gravity, read when the game starts
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
 	TArray<FName> StopTags;
 
-	// Tags that can be used to start gravity
+	// Tags that can be used to start gravity, read when the game starts
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
 	TArray<FName> StartTags;
 
@@ -69,4 +77,16 @@ public:
 	/** Stop or Start Gravity if collided component or actor has the corresponding start/stop tag */
 	UFUNCTION(BlueprintCallable, Category = "VR")
 	void ProcessTags(AActor* OtherActor, UPrimitiveComponent* OtherComp);
+
+private:
+	// Stop and start tags as sets for tag lookups, built when the game starts
+	TSet<FName> StopTagSet;
+	TSet<FName> StartTagSet;
+
+	// Fixed step gravity simulation and the actor's drawn location between steps
+	FVRFixedTimestep GravityTimestep;
+	FVRInterpolatedMove GravityInterpolation;
+
+	// Movement of one gravity step
+	FVector GetGravityStep() const;
 };
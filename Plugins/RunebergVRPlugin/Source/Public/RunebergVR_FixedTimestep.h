@@ -0,0 +1,118 @@
+// Copyright (C) 2016, 2017 Runeberg (github: 1runeberg, UE4 Forums: runeberg)
+
+/*
+The MIT License (MIT)
+Copyright (c) 2016, 2017 runeberg (github: 1runeberg, UE4 Forums: runeberg)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Fixed timestep accumulator - lets a component simulate at a fixed rate regardless of the render frame rate
+ */
+struct FVRFixedTimestep
+{
+	/** Frame rate the plugin's per frame speeds were tuned at - a fixed step moves as far as a frame at this rate would, scaled by its length */
+	static constexpr float ReferenceRate = 90.f;
+
+	/** Length of one simulation step in seconds, 0 steps once per frame */
+	float StepTime = 0.f;
+
+	/** Max steps per frame so a long hitch doesn't spiral into catching up */
+	int32 MaxStepsPerFrame = 8;
+
+	/** Frame time not yet simulated */
+	float Accumulator = 0.f;
+
+	/** Set the simulation rate in Hz, 0 or less steps once per frame */
+	void SetRate(float Rate)
+	{
+		StepTime = Rate > 0.f ? 1.f / Rate : 0.f;
+	}
+
+	/** Add this frame's time and get the number of simulation steps to run */
+	int32 Advance(float DeltaTime)
+	{
+		if (StepTime <= 0.f)
+		{
+			return 1;
+		}
+
+		Accumulator += DeltaTime;
+		int32 Steps = FMath::FloorToInt(Accumulator / StepTime);
+		Accumulator -= Steps * StepTime;
+
+		// Drop the time we can't catch up on
+		if (Steps > MaxStepsPerFrame)
+		{
+			Steps = MaxStepsPerFrame;
+		}
+
+		return Steps;
+	}
+
+	/** How far this frame is between the last two simulation steps (0 - 1), for interpolating what gets rendered */
+	float GetAlpha() const
+	{
+		return StepTime > 0.f ? FMath::Clamp(Accumulator / StepTime, 0.f, 1.f) : 1.f;
+	}
+
+	/** How much of a per frame speed to apply in one step - 1 when stepping once per frame */
+	float GetStepScale() const
+	{
+		return StepTime > 0.f ? ReferenceRate * StepTime : 1.f;
+	}
+
+	/** Clear the accumulator, optionally making the next Advance run a step straight away */
+	void Reset(bool bStepOnNextAdvance = false)
+	{
+		Accumulator = bStepOnNextAdvance ? StepTime : 0.f;
+	}
+};
+
+/**
+ * Draws a fixed timestep mover between its last two steps. The mover's real location is always the drawn one, so moves made
+ * by anything else (teleports, other components) carry over to the simulation without any extra bookkeeping
+ */
+struct FVRInterpolatedMove
+{
+	/** How far the drawn location trails the simulated one */
+	FVector Lag = FVector::ZeroVector;
+
+	/** Movement of the last simulation step */
+	FVector LastStepDelta = FVector::ZeroVector;
+
+	/** Where the simulation is, given where the mover is drawn */
+	FVector GetSimLocation(const FVector& DrawnLocation) const
+	{
+		return DrawnLocation + Lag;
+	}
+
+	/** Record a simulation step */
+	void AddStep(const FVector& Delta)
+	{
+		LastStepDelta = Delta;
+	}
+
+	/** Where to draw the mover this frame */
+	FVector GetDrawLocation(const FVector& SimLocation, float Alpha)
+	{
+		Lag = LastStepDelta * (1.f - Alpha);
+		return SimLocation - Lag;
+	}
+
+	/** Forget the last step, e.g. when the mover stops */
+	void Reset()
+	{
+		Lag = FVector::ZeroVector;
+		LastStepDelta = FVector::ZeroVector;
+	}
+};
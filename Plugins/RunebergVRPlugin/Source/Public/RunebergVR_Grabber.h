@@ -15,6 +15,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 #include "Components/ActorComponent.h"
 #include "Engine.h"
+#include "Components/SphereComponent.h"
 #include "RunebergVR_Grabber.generated.h"
 
 UENUM(BlueprintType)		
@@ -28,6 +29,17 @@ enum class EGrabTypeEnum : uint8
 
 };
 
+UENUM(BlueprintType)
+enum class EGrabHoldMode : uint8
+{
+	ACTOR_TRANSFORM	UMETA(DisplayName = "Set Actor Location and Rotation"),
+	PHYSICS_HANDLE	UMETA(DisplayName = "Physics Handle Target Only"),
+	KINEMATIC		UMETA(DisplayName = "Kinematic, Single Transform Update"),
+	LATE_UPDATE		UMETA(DisplayName = "Attached to Controller, Late Updated"),
+	PHYSICS_SUBSTEP	UMETA(DisplayName = "Driven on Physics Substeps")
+
+};
+
 UCLASS( ClassGroup=(VR), meta=(BlueprintSpawnableComponent) )
 class RUNEBERGVRPLUGIN_API URunebergVR_Grabber : public USceneComponent
 {
@@ -37,6 +49,12 @@ public:
 	// Sets default values for this component's properties
 	URunebergVR_Grabber();
 
+	// Called when the game starts
+	virtual void BeginPlay() override;
+
+	// Called when the game ends
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	// Called every frame
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
@@ -44,6 +62,52 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
 	TArray<TEnumAsByte<EObjectTypeQuery>> Grabbable_ObjectTypes;
 
+	/** Keep grab candidates from a proximity volume's overlaps, so Grab picks from them without a trace. Grab's Reach still limits how far a candidate can be, Do Radial Trace doesn't apply */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
+	bool bUseGrabVolume = false;
+
+	/** Radius of the grab proximity volume */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
+	float GrabVolumeRadius = 10.f;
+
+	/** Trace for what would be grabbed in the background while not holding anything, e.g. for highlighting - Grab reuses a fresh result with the same reach and trace type */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
+	bool bPredictGrabTarget = false;
+
+	/** Predictive grab traces per second */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
+	float GrabPredictionRate = 20.f;
+
+	/** Reach of the predictive grab trace */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
+	float GrabPredictionReach = 5.f;
+
+	/** Whether the predictive grab trace is radial instead of a line trace */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
+	bool bGrabPredictionRadialTrace = false;
+
+	/** Max age in seconds of a predictive grab result that Grab will reuse */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
+	float GrabPredictionMaxAge = 0.1f;
+
+	/** Actor that would be grabbed now, from the predictive grab trace */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "VR - Read Only")
+	AActor* PredictedGrabActor = nullptr;
+
+	/** Where the predictive grab trace hit the predicted actor */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "VR - Read Only")
+	FVector PredictedGrabLocation = FVector::ZeroVector;
+
+	/** How grabbed objects follow the controller - physics handle only lets physics move the object, kinematic turns off its physics while held and moves it once per frame,
+	  * late update holds it kinematic and attached to the motion controller so its render transform gets the controller's late update,
+	  * physics substep drives it on every physics substep towards a target interpolated between the last two controller poses */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
+	EGrabHoldMode HoldMode = EGrabHoldMode::ACTOR_TRANSFORM;
+
+	/** Max objects held at once by GrabMultiple */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
+	int32 MaxMultiGrabObjects = 256;
+
 	// Current Distance of grabbed items from their respective controllers
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "VR")
 	float DistanceFromController = 10.0f;
@@ -72,10 +136,30 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
 	float SunBrightness = 75.f;
 
+	/** Sun updates per second while grabbing the sun, 0 updates every frame - the light and sky are redrawn on each update */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
+	float SunUpdateRate = 0.f;
+
+	/** Min sun pitch change in degrees before the sun is updated while grabbing the sun */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
+	float SunMinAngleDelta = 0.1f;
+
 	// Grab something within line trace range of controller
 	UFUNCTION(BlueprintCallable, Category = "VR")
 	AActor* Grab(float Reach = 5.f, bool DoRadialTrace = false, bool ScanOnlyWillManuallyAttach= false, EGrabTypeEnum GrabMode = EGrabTypeEnum::PRECISION_GRAB, FName TagName = FName(TEXT("")), FRotator Rotation_Offset = FRotator::ZeroRotator, bool RetainObjectRotation = true, bool RetainDistance = false, bool ShowDebug = false);
 
+	// Grab every simulating object within radius of the grabber, keeping their offsets to it (e.g. magnets, lassos) - returns how many were grabbed
+	UFUNCTION(BlueprintCallable, Category = "VR")
+	int32 GrabMultiple(float Radius = 50.f, FName TagName = FName(TEXT("")), bool ShowDebug = false);
+
+	// Release all objects held by GrabMultiple, they keep their velocity - returns how many were released
+	UFUNCTION(BlueprintCallable, Category = "VR")
+	int32 ReleaseMultiple();
+
+	// Number of objects held by GrabMultiple
+	UFUNCTION(BlueprintPure, Category = "VR")
+	int32 GetNumMultiGrabbed() const { return MultiGrabComponents.Num(); }
+
 	// Set distance from controller
 	UFUNCTION(BlueprintCallable, Category = "VR")
 	void SetDistanceFromController(float NewDistance, float MinDistance, float MaxDistance);
@@ -105,6 +189,43 @@ public:
 	bool GrabSun(AActor* Sky_Sphere, float SunCycleRate = 2.f);
 
 private:
+	// Grab proximity volume and the grabbable actors overlapping it, with their physics handles
+	struct FGrabCandidate
+	{
+		TWeakObjectPtr<AActor> Actor;
+		TWeakObjectPtr<UPhysicsHandleComponent> PhysicsHandle;
+		int32 OverlapCount;
+	};
+	UPROPERTY()
+	USphereComponent* GrabVolume = nullptr;
+	TArray<FGrabCandidate> GrabCandidates;
+
+	UFUNCTION()
+	void OnGrabVolumeBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+
+	UFUNCTION()
+	void OnGrabVolumeEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex);
+
+	// Closest grab candidate within reach with a physics handle (and tag, if any)
+	AActor* GetGrabCandidate(float Reach, FName TagName, bool RetainDistance, UPhysicsHandleComponent*& OutPhysicsHandle);
+
+	// Predictive grab trace, run asynchronously
+	FTraceDelegate GrabPredictionDelegate;
+	bool bGrabPredictionPending = false;
+	float GrabPredictionTime = -1000.f;
+	float GrabPredictionResultTime = -1000.f;
+	float GrabPredictionResultReach = 0.f;
+	bool bGrabPredictionResultRadial = false;
+	float PredictedGrabDistance = 0.f;
+	FVector PredictedGrabLocalLocation = FVector::ZeroVector;
+	TWeakObjectPtr<UPhysicsHandleComponent> PredictedPhysicsHandle;
+
+	// Start the next predictive grab trace
+	void UpdateGrabPrediction();
+
+	// Predictive grab trace is done
+	void OnGrabPredictionTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
 	// Motion Controller Transform
 	FVector ControllerLocation = FVector::ZeroVector;
 	FRotator ControllerRotation = FRotator::ZeroRotator;
@@ -116,6 +237,45 @@ private:
 	FRotator StandardOffset = FRotator::ZeroRotator;
 	FRotator RotationOffset = FRotator::ZeroRotator;
 
+	// Grabbed object held kinematic, to simulate again on release
+	TWeakObjectPtr<UPrimitiveComponent> KinematicHeldComponent;
+
+	// Grabbed object attached to the motion controller, to detach on release - not set when the grabber isn't on a motion controller
+	TWeakObjectPtr<UPrimitiveComponent> AttachedHeldComponent;
+
+	// Objects held by GrabMultiple, one entry each - the component's own body is driven by velocity towards its offset from the grabber.
+	// Bodies are looked up from the component every time as they can be recreated (e.g. skeletal mesh physics state)
+	TArray<TWeakObjectPtr<UPrimitiveComponent>> MultiGrabComponents;
+	TSet<TWeakObjectPtr<UPrimitiveComponent>> MultiGrabComponentSet;
+	TArray<FTransform> MultiGrabOffsets;
+	TArray<bool> MultiGrabGravity;
+
+	// Drive all objects held by GrabMultiple towards their hold targets
+	void UpdateMultiGrab(float DeltaTime);
+
+	// Drop an object held by GrabMultiple
+	void RemoveMultiGrabbed(int32 Index);
+
+	// Hold targets of the last two frames for physics substep holds, the substeps move between them. The physics handle lets go
+	// of substep held objects so its drive doesn't pull them to the end of frame target
+	FCalculateCustomPhysics SubstepHoldDelegate;
+	TWeakObjectPtr<UPrimitiveComponent> SubstepHeldComponent;
+	FTransform PrevHoldTarget = FTransform::Identity;
+	FTransform CurrHoldTarget = FTransform::Identity;
+	bool bHoldTargetValid = false;
+	bool bSubstepHoldRotation = false;
+	float HoldFrameTime = 0.f;
+	float HoldSubstepTime = 0.f;
+
+	// Physics substep callback for physics substep holds
+	void SubstepHeldObject(float DeltaTime, FBodyInstance* BodyInstance);
+
+	// Where the grabbed object should be this frame, bOutSetRotation is false for grab types that leave the rotation to physics
+	void GetHoldTarget(FVector& OutLocation, FRotator& OutRotation, bool& bOutSetRotation);
+
+	// Move the grabbed object to its hold target
+	void UpdateHeldObject();
+
 	// Get Actor hit by line trace
 	AActor* GetHit(bool DoRadialTrace, float Reach, FVector LineTraceStart, FVector LineTraceEnd, bool RetainDistance, bool bShowDebugLine);
 	bool bManualAttach = false;
@@ -136,4 +296,15 @@ private:
 	ULightComponent* SunDirectionalLightComponent = nullptr;
 	FRotator RotationDuringGrab = FRotator::ZeroRotator;
 	void UpdateDayNight();
+
+	// Sky sphere reflection, cached per sky sphere class
+	UFloatProperty* SunBrightnessProperty = nullptr;
+	UFunction* UpdateSunDirectionFunction = nullptr;
+
+	// Sun rotation not applied yet
+	float PendingSunPitch = 0.f;
+	float LastSunUpdateTime = -1000.f;
+
+	// Rotate the sun by the pending pitch and update the sky sphere
+	void ApplySunUpdate();
 };
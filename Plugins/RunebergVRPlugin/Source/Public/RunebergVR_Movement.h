@@ -17,9 +17,65 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include "GameFramework/Actor.h"
 #include "TimerManager.h"
 #include "Components/ActorComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "RunebergVR_FixedTimestep.h"
 #include "Runtime/NavigationSystem/Public/NavigationSystem.h"
+#include "Engine/NetSerialization.h"
 #include "RunebergVR_Movement.generated.h"
 
+// One quantized movement step, repeated Steps times - 8 bytes on the wire
+struct FVRQuantizedMove
+{
+	uint16 Yaw = 0;
+	uint16 Pitch = 0;
+	uint16 Speed = 0;		// Distance per step in 0.1 units
+	uint8 Steps = 1;
+	uint8 Flags = 0;
+
+	enum
+	{
+		FLAG_ObeyNavMesh = 1	// What the client predicted with, the server goes by its own bNetMovesObeyNavMesh
+	};
+
+	FVRQuantizedMove() {}
+	FVRQuantizedMove(const FVector& StepMove, bool bObeyNavMesh);
+
+	/** Movement of a single step */
+	FVector GetStepMove() const;
+
+	/** Same input, so the two can be run length encoded */
+	bool IsSameInput(const FVRQuantizedMove& Other) const
+	{
+		return Yaw == Other.Yaw && Pitch == Other.Pitch && Speed == Other.Speed && Flags == Other.Flags;
+	}
+};
+
+// Batch of client moves sent to the server, resent until acknowledged
+USTRUCT()
+struct FVRMoveBatch
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** Max moves in one batch */
+	static const int32 MaxMoves = 64;
+
+	/** Sequence number of the first move */
+	uint32 Sequence = 0;
+
+	TArray<FVRQuantizedMove> Moves;
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FVRMoveBatch> : public TStructOpsTypeTraitsBase2<FVRMoveBatch>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
 
 UCLASS( ClassGroup=(VR), meta=(BlueprintSpawnableComponent) )
 class RUNEBERGVRPLUGIN_API URunebergVR_Movement : public UActorComponent
@@ -34,6 +90,9 @@ protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
 
+	// Called when the game ends
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 public:
 	// Called every frame
 	virtual void TickComponent( float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction ) override;
@@ -58,6 +117,31 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
 	FVector NavMeshTolerance = FVector(10.f, 10.f, 10.f);
 
+	/** When obeying the nav mesh, slide along nav mesh edges instead of stopping at them */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
+	bool bSlideAlongNavMesh = true;
+
+	/** Rate (Hz) to simulate movement at, the pawn is drawn between steps. Speeds keep their per frame feel at 90 fps. 0 moves once per frame */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
+	float FixedStepRate = 0.f;
+
+	/** Sweep the pawn's capsule on each move and slide along what it hits, instead of teleporting the pawn every frame */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
+	bool bSweepMovement = true;
+
+	/** How much of the bottom of the capsule is left out of the movement sweep, so floors and small steps don't block */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
+	float SweepStepHeight = 45.f;
+
+	/** Max sweeps a dash move is split into per frame - fast dashes are swept in steps of about a capsule radius */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
+	int32 MaxDashSubsteps = 4;
+
+	/** Move this pawn with the world's movement batcher instead of ticking the component - for large numbers of simulated pawns.
+	  * Batched moves are checked against the nav mesh but aren't swept, interpolated or replicated */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
+	bool bUseBatchedLocomotion = false;
+
 	/** Indicator if the pawn is moving */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
 	bool IsMoving = false;	
@@ -70,6 +154,81 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
 	bool EnableTerrainCheck = false;
 
+	/** Bounce back from VR bounds when the HMD or a motion controller gets near the edge of the play area (chaperone) while moving */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Play Area")
+	bool bBounceBackFromPlayArea = false;
+
+	/** Distance from the play area edge that triggers the bounce back */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Play Area")
+	float PlayAreaWarningDistance = 20.f;
+
+	/** Bounce back speed when nearing the play area edge */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Play Area")
+	float PlayAreaBounceSpeed = 3.f;
+
+	/** Bounce back duration when nearing the play area edge */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Play Area")
+	float PlayAreaBounceDuration = 0.5f;
+
+	/** Closest distance of the HMD or a motion controller to the play area edge, negative when outside of it */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "VR - Read Only")
+	float DistanceToPlayAreaEdge = 0.f;
+
+	/** Predict movement on the owning client and send it to the server as compact move batches (the pawn should replicate its movement for other players) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Network")
+	bool bReplicateVRMovement = false;
+
+	/** Seconds between move batches sent to the server */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Network")
+	float MoveSendInterval = 0.05f;
+
+	/** How far the server's location can be from the predicted one before the client corrects */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Network")
+	float NetCorrectionTolerance = 5.f;
+
+	/** Fastest per frame speed the server accepts from a client (covers speed multipliers and bounce backs), scaled by the fixed step */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Network")
+	float MaxNetMovementSpeed = 20.f;
+
+	/** Most movement steps per second the server accepts when not running at a fixed step rate (one step per client frame, so cover the fastest headset refresh rate) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Network")
+	float MaxNetStepRate = 144.f;
+
+	/** Seconds of client movement the server lets run ahead of its own clock, for batches that bunch up on the way */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Network")
+	float NetMoveTimeTolerance = 0.5f;
+
+	/** Keep replicated moves on the nav mesh - the server's setting is used, whatever the client asked for */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Network")
+	bool bNetMovesObeyNavMesh = false;
+
+	/** Furthest the server lets a client teleport its pawn in one go, 0 for no limit. Teleports are also kept on the nav mesh if Net Moves Obey Nav Mesh is on */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Network")
+	float MaxNetTeleportDistance = 2000.f;
+
+	/** Movement bytes this client sent to the server during the last second */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "VR - Read Only")
+	int32 NetBytesPerSecond = 0;
+
+	// Client moves for the server to simulate
+	UFUNCTION(Server, Unreliable, WithValidation)
+	void ServerMoveBatch(const FVRMoveBatch& Batch);
+
+	// Server result of the client's moves up to Sequence
+	UFUNCTION(Client, Unreliable)
+	void ClientAckMoves(uint32 Sequence, FVector_NetQuantize100 ServerLocation);
+
+	// Client teleported its pawn after its moves up to Sequence
+	UFUNCTION(Server, Reliable, WithValidation)
+	void ServerTeleport(uint32 Sequence, FVector_NetQuantize100 Location);
+
+	// Server didn't accept the client's teleport, the pawn is still at ServerLocation
+	UFUNCTION(Client, Reliable)
+	void ClientRejectTeleport(FVector_NetQuantize100 ServerLocation);
+
+	// The pawn was moved outright (e.g. teleported) - a predicting client drops its moves in flight and has the server move the pawn too
+	void NotifyPawnTeleported();
+
 	// Enable VR Movement
 	UFUNCTION(BlueprintCallable, Category = "VR")
 	void EnableVRMovement(float MovementSpeed = 3.f, USceneComponent* MovementDirectionReference = nullptr, bool ObeyNavMesh = false,
@@ -100,7 +259,19 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "VR")
 	void BounceBackFromVRBounds(float MovementSpeed = 3.f, float MovementDuration = 0.5f, bool ResetMovementStateAfterBounce=false);
 
+	// Use a fixed play area polygon (tracking space, unreal units) instead of the chaperone's, e.g. without a headset - an empty array goes back to the chaperone
+	UFUNCTION(BlueprintCallable, Category = "VR")
+	void SetPlayAreaPolygon(const TArray<FVector2D>& Points);
+
+	// Chaperone play area corners (OpenVR - meters, right handed, Y up) as a tracking space polygon in unreal units
+	static TArray<FVector2D> ChaperoneToPlayAreaPolygon(const TArray<FVector>& Corners, float WorldToMeters);
+
+	// Signed distance of a tracking space point to the play area edge, negative when outside
+	float GetDistanceToPlayAreaEdge(const FVector2D& Point) const;
+
 private:
+	friend class FRunebergVRMovementBatcher;
+
 	AActor* VRPawn = nullptr;	// The VR Pawn that this component is attached to
 	float BounceBackSpeed = 0.f;
 	bool bObeyNavMesh = false;
@@ -110,12 +281,121 @@ private:
 	bool bResetMovementStateAfterBounce = false;
 	bool bIsMovingCache = false;
 
+	bool bBatched = false;
+
+	// Update TargetRotation from the movement reference, offset and axis locks
+	void UpdateTargetRotation();
+
 	// Move VR Pawn
 	void MoveVRPawn(float MovementSpeed, USceneComponent* MovementDirectionReference, bool LockXAxis, bool LockYAxis, bool LockZAxis, FRotator CustomDirection, bool ShouldObeyNavMesh = false);
 
 	// Disable VR Bounds Bounce Back Movement
 	void DisableVRBounceBack();
 
+	// Pawn capsule used for movement sweeps
+	UCapsuleComponent* PawnCapsule = nullptr;
+	bool bIsDashing = false;
+
+	// Fixed step movement simulation and the pawn's drawn location between steps
+	FVRFixedTimestep MovementTimestep;
+	FVRInterpolatedMove MovementInterpolation;
+
+	// Latest full 360 movement input, simulated on tick when running at a fixed step rate
+	FRotator Input360Rotation = FRotator::ZeroRotator;
+	bool bInput360ObeyNavMesh = false;
+	uint64 Last360InputFrame = 0;
+
+	// Moves predicted on this client that the server hasn't acknowledged yet
+	struct FVRPendingMove
+	{
+		FVRQuantizedMove Move;
+		uint32 Sequence;
+		FVector EndLocation;
+	};
+	TArray<FVRPendingMove> PendingMoves;
+	int32 NumSentMoves = 0;
+	uint32 NextMoveSequence = 1;
+	uint32 LastServerMoveSequence = 0;
+	float ServerMoveClock = -1.f;
+	float LastMoveSendTime = 0.f;
+	float NetBytesWindowStart = 0.f;
+	int32 NetBytesInWindow = 0;
+
+	// Whether this is the owning client of a replicated VR movement
+	bool IsPredictingMoves() const;
+
+	// Keep a predicted move for the server, run length encoded with the last unsent one
+	void SaveMove(const FVRQuantizedMove& Move, const FVector& EndLocation);
+
+	// Send unacknowledged moves to the server
+	void SendMoves();
+
+	// Longest single step the server accepts
+	float GetMaxNetStepDistance() const;
+
+	// Seconds of client time one step stands for
+	float GetNetStepTime() const;
+
+	// Server time client moves have used up to, never further back than the tolerance
+	float GetServerMoveClock() const;
+
+	// Run one movement step from InOutLocation, returns false if the nav mesh stopped it
+	bool SimulateMove(const FVector& StepMove, bool bNavMesh, FVector& InOutLocation);
+
+	// Advance the movement simulation and draw the pawn
+	void StepMovement(float DeltaTime, const FRotator& Direction, float Speed, bool bNavMesh, bool bStopOnNavMeshEdge);
+
+	// Whether moves are swept with the pawn capsule
+	bool CanSweepMovement() const;
+
+	// How far the pawn can get from From towards TargetLocation, sweeping its capsule if enabled
+	FVector SweepMove(const FVector& From, const FVector& TargetLocation) const;
+
+	// Put the pawn at Location
+	void SetPawnLocation(const FVector& Location);
+
+	// Sweep the capsule by Delta, sliding along blocking hits, returns how far it got
+	FVector SweepCapsule(const FVector& Start, const FVector& Delta, const FCollisionShape& Shape, const FCollisionQueryParams& QueryParams, const FCollisionResponseParams& ResponseParams) const;
+
+	// Play area edges in tracking space, precomputed for point to segment distances
+	struct FPlayAreaEdge
+	{
+		FVector2D Start;
+		FVector2D Direction;
+		float InvLengthSquared;
+	};
+	TArray<FPlayAreaEdge> PlayAreaEdges;
+	bool bPlayAreaOverridden = false;
+	bool bPlayAreaDirty = true;
+	bool bNearPlayAreaEdge = false;
+	FDelegateHandle HeadsetRecenterHandle;
+	FDelegateHandle HeadsetPutOnHeadHandle;
+	FDelegateHandle HeadsetReconnectedHandle;
+	FDelegateHandle TrackingInitializedHandle;
+
+	// Tracking space of the pawn and the tracked components checked against the play area, held weakly as they can be destroyed with the pawn still around
+	TWeakObjectPtr<USceneComponent> TrackingOrigin;
+	TArray<TWeakObjectPtr<USceneComponent>> TrackedComponents;
+
+	// Read the play area from the chaperone
+	void RefreshPlayArea();
+
+	// Precompute the play area edges of a polygon
+	void BuildPlayAreaEdges(const TArray<FVector2D>& Points);
+
+	// Bounce back if a tracked component just got too close to the play area edge
+	void CheckPlayAreaBounds();
+
+	// Play area may have moved or been set up again
+	void OnPlayAreaChanged();
+
+	// Nav poly the pawn is on and where on it, so nav constrained moves only search locally
+	NavNodeRef CurrentNavPoly = INVALID_NAVNODEREF;
+	FVector CurrentNavLocation = FVector::ZeroVector;
+
+	// Advance from the current nav poly from From towards TargetLocation, returns false if the pawn can't move
+	bool MoveAlongNavMesh(const FVector& From, const FVector& TargetLocation, FVector& OutLocation);
+
 	// Whether we have hit something with the line trace that can cause this pawn to stop falling if gravity is enabled
 	bool bHit = false;
 };
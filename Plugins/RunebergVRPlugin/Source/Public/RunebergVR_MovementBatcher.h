@@ -0,0 +1,80 @@
+// Copyright (C) 2017 Runeberg (github: 1runeberg, UE4 Forums: runeberg)
+
+/*
+The MIT License (MIT)
+Copyright (c) 2017 runeberg (github: 1runeberg, UE4 Forums: runeberg)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "RunebergVR_MovementBatcher.generated.h"
+
+class URunebergVR_Movement;
+class FRunebergVRMovementBatcher;
+
+// World tick for the movement batcher
+USTRUCT()
+struct FRunebergVRMovementBatchTickFunction : public FTickFunction
+{
+	GENERATED_USTRUCT_BODY()
+
+	FRunebergVRMovementBatcher* Batcher = nullptr;
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FRunebergVRMovementBatchTickFunction> : public TStructOpsTypeTraitsBase2<FRunebergVRMovementBatchTickFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
+/**
+ * Moves all batched VR movement components of a world in one tick - play area checks and targets are worked out in one pass,
+ * nav mesh projections go to the navigation system as one batch and the pawns are moved in a single pass
+ */
+class RUNEBERGVRPLUGIN_API FRunebergVRMovementBatcher
+{
+public:
+	FRunebergVRMovementBatcher(UWorld* InWorld);
+	~FRunebergVRMovementBatcher();
+
+	/** Get the movement batcher for a world, creating it if needed */
+	static FRunebergVRMovementBatcher& Get(UWorld* World);
+
+	/** Drop the movement batcher of a world that is being cleaned up */
+	static void OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+
+	/** Add a movement component, it stops ticking on its own */
+	void AddComponent(URunebergVR_Movement* Component);
+
+	/** Remove a movement component */
+	void RemoveComponent(URunebergVR_Movement* Component);
+
+	/** Move every active component */
+	void Tick(float DeltaTime);
+
+private:
+	UWorld* World;
+	FRunebergVRMovementBatchTickFunction TickFunction;
+
+	// Registered components
+	TArray<URunebergVR_Movement*> Components;
+
+	// Per frame data of the active components, one entry each
+	TArray<URunebergVR_Movement*> ActiveComponents;
+	TArray<FVector> Targets;
+	TArray<bool> bCanMove;
+};
@@ -19,6 +19,7 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include "Components/StaticMeshComponent.h"
 #include "Camera/CameraComponent.h"
 #include "MotionControllerComponent.h"
+#include "RunebergVR_FixedTimestep.h"
 #include "RunebergVR_Pawn.generated.h"
 
 // Gravity settings
@@ -90,6 +91,10 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
 	FGravityVariables GravityVariables;
 
+	/** Rate (Hz) to simulate gravity at, the pawn is drawn between steps. Gravity keeps its per frame feel at 90 fps. 0 steps once per frame */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
+	float GravityStepRate = 0.f;
+
 	/** Uneven Terrain Step Up rate */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
 	float StepUpRate = .001f;
@@ -145,4 +150,11 @@ private:
 	bool bHit = false;
 	
 	float CurrentGravityStrength = 0.f;
+
+	// Fixed step gravity simulation and the pawn's drawn location between steps
+	FVRFixedTimestep GravityTimestep;
+	FVRInterpolatedMove GravityInterpolation;
+
+	// Run one gravity step from Location, tracing for a floor below TracePosition
+	FVector StepGravity(const FVector& Location, const FVector& TracePosition, float StepScale);
 };
@@ -36,6 +36,14 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
 	float GrabSphereRadius = 8.f;
 
+	/** Grab the candidate closest to the grabber, instead of the first one to overlap */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
+	bool bGrabNearest = true;
+
+	/** Candidates with this tag are grabbed before any others */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
+	FName PriorityTag;
+
 	// Enable grab
 	UFUNCTION(BlueprintCallable, Category = "VR")
 	void Grab(int _ObjectTypeID = 5);
@@ -59,4 +67,17 @@ private:
 	AActor* GrabbedObject = nullptr;					// Grabbed Actor
 	UPrimitiveComponent* GrabbedComponent = nullptr;	// Grabbed Actor
 	int ObjectTypeID = 5;								// EChannelCollision ID of "Grabbable Objects" default is 5 for PhaysicsBody
+
+	// Grabbable components overlapping the sphere while grabbing
+	TArray<TWeakObjectPtr<UPrimitiveComponent>> GrabCandidates;
+	bool bCollectingCandidates = false;
+
+	// Turn the sphere's overlap events on or off, they are only needed while grabbing
+	void SetGrabOverlapsEnabled(bool bEnabled);
+
+	// Grab the best candidate, if any
+	void GrabBestCandidate();
+
+	// Attach an overlapping component's actor to the grabber
+	void GrabComponent(UPrimitiveComponent* Component);
 };
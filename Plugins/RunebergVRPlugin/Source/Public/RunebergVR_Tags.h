@@ -0,0 +1,34 @@
+// Copyright (C) 2017 Runeberg (github: 1runeberg, UE4 Forums: runeberg)
+
+/*
+The MIT License (MIT)
+Copyright (c) 2017 runeberg (github: 1runeberg, UE4 Forums: runeberg)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Tag checks of actors and components, against a set of tags to look for so filtering by a tag array doesn't walk it for every tag of every object.
+ * Tags are always read live from the object, so tags added or removed at runtime are picked up
+ */
+class RUNEBERGVRPLUGIN_API FRunebergVRTags
+{
+public:
+	/** Whether an actor or component has a tag */
+	static bool HasTag(const UObject* Object, FName Tag);
+
+	/** Whether an actor or component has any of the tags */
+	static bool HasAnyTag(const UObject* Object, const TSet<FName>& Tags);
+
+private:
+	// Live tags of an actor or component, null for anything else
+	static const TArray<FName>* GetObjectTags(const UObject* Object);
+};
@@ -0,0 +1,91 @@
+// Copyright (C) 2017 Runeberg (github: 1runeberg, UE4 Forums: runeberg)
+
+/*
+The MIT License (MIT)
+Copyright (c) 2017 runeberg (github: 1runeberg, UE4 Forums: runeberg)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "Components/SceneComponent.h"
+#include "RunebergVR_TeleportAnchor.generated.h"
+
+class URunebergVR_TeleportAnchor;
+
+/**
+ * Uniform spatial hash of the teleport anchors in a world, anchors add and remove themselves as they are registered
+ */
+class RUNEBERGVRPLUGIN_API FRunebergVRTeleportAnchorHash
+{
+public:
+	/** Size of a hash cell in world units - anchors further apart than this never share a cell */
+	static const float CellSize;
+
+	/** Get the anchor hash for a world, creating it if needed */
+	static FRunebergVRTeleportAnchorHash& Get(UWorld* World);
+
+	/** Get the anchor hash for a world if it has one, never creates it */
+	static FRunebergVRTeleportAnchorHash* Find(UWorld* World);
+
+	/** Drop the anchor hash of a world that is being cleaned up */
+	static void OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+
+	/** Add or move an anchor */
+	void UpdateAnchor(URunebergVR_TeleportAnchor* Anchor);
+
+	/** Remove an anchor */
+	void RemoveAnchor(URunebergVR_TeleportAnchor* Anchor);
+
+	/** Find the closest enabled anchor within Radius of Point, nullptr if none */
+	URunebergVR_TeleportAnchor* FindNearestAnchor(const FVector& Point, float Radius) const;
+
+	/** Number of anchors in the hash */
+	int32 Num() const { return AnchorCells.Num(); }
+
+private:
+	// Anchor and its location when it was hashed, so lookups never touch the component
+	struct FAnchorEntry
+	{
+		URunebergVR_TeleportAnchor* Anchor;
+		FVector Location;
+	};
+
+	// Anchors per cell
+	TMap<FIntVector, TArray<FAnchorEntry>> Cells;
+
+	// Cell each anchor currently lives in
+	TMap<URunebergVR_TeleportAnchor*, FIntVector> AnchorCells;
+
+	static FIntVector GetCell(const FVector& Location);
+};
+
+/**
+ * Curated teleport point - the teleporter snaps its target to the nearest anchor when enabled
+ */
+UCLASS(ClassGroup = (VR), meta = (BlueprintSpawnableComponent))
+class RUNEBERGVRPLUGIN_API URunebergVR_TeleportAnchor : public USceneComponent
+{
+	GENERATED_BODY()
+
+public:
+	URunebergVR_TeleportAnchor();
+
+	/** Whether the teleporter can currently snap to this anchor */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
+	bool bAnchorEnabled = true;
+
+	/** Use this anchor's rotation for the target marker instead of facing the pawn */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
+	bool bUseAnchorRotation = false;
+
+protected:
+	virtual void OnRegister() override;
+	virtual void OnUnregister() override;
+	virtual void OnUpdateTransform(EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport = ETeleportType::None) override;
+};
@@ -0,0 +1,75 @@
+// Copyright (C) 2016, 2017 Runeberg (github: 1runeberg, UE4 Forums: runeberg)
+
+/*
+The MIT License (MIT)
+Copyright (c) 2016, 2017 runeberg (github: 1runeberg, UE4 Forums: runeberg)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "Engine/DataAsset.h"
+#include "RunebergVR_TeleportGrid.generated.h"
+
+// Result of a teleport grid lookup
+enum class ETeleportGridQuery : uint8
+{
+	Invalid,		// No nav mesh anywhere in this cell's column
+	Valid,			// Cell is fully on the nav mesh, its floor is the baked corner heights
+	Unresolved		// Cell is at a nav mesh edge, uneven, on another floor or outside the grid - check the nav mesh
+};
+
+/**
+ * Baked 2.5D grid of valid teleport cells (floor heights at the cell corners), used by the teleporter to skip nav mesh projections
+ */
+UCLASS(BlueprintType)
+class RUNEBERGVRPLUGIN_API URunebergVR_TeleportGrid : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	/** Size of a single grid cell in world units - smaller cells hug nav mesh edges better but make a bigger asset */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
+	float CellSize = 50.f;
+
+	/** Height precision of the baked floor heights in world units */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
+	float HeightStep = 2.f;
+
+	/** Max floor height difference within a cell before it is treated as a nav mesh edge (stairs, ledges) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
+	float MaxCellHeightVariance = 20.f;
+
+	/** How close to the nav mesh a cell sample needs to be to count as valid */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR")
+	float SampleTolerance = 10.f;
+
+	/** Bake the grid from the current navigation data. Call from an editor utility on the editor world, leave bounds empty to use the nav mesh bounds */
+	UFUNCTION(BlueprintCallable, Category = "VR", meta = (WorldContext = "WorldContextObject"))
+	int32 BakeFromNavMesh(UObject* WorldContextObject, FBox BakeBounds);
+
+	/** Check a location against the grid, OutLocation is set to the point on the baked floor when valid */
+	ETeleportGridQuery QueryLocation(const FVector& Point, const FVector& Extent, FVector& OutLocation) const;
+
+	/** Number of cells in X and Y */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "VR - Read Only")
+	FIntPoint GridSize = FIntPoint::ZeroValue;
+
+	/** World location of the grid's min corner */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "VR - Read Only")
+	FVector GridOrigin = FVector::ZeroVector;
+
+private:
+	// Per cell ETeleportGridQuery value
+	UPROPERTY()
+	TArray<uint8> CellStates;
+
+	// Per corner floor height, in HeightStep units above GridOrigin.Z - (GridSize.X + 1) * (GridSize.Y + 1) corners
+	UPROPERTY()
+	TArray<int16> CornerHeights;
+};
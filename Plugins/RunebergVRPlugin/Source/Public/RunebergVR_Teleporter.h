@@ -17,7 +17,11 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 #include "Components/SplineComponent.h"
 #include "Components/SplineMeshComponent.h"
 #include "Particles/ParticleSystemComponent.h"
+#include "Engine/LevelStreaming.h"
 #include "Runtime/NavigationSystem/Public/NavigationSystem.h"
+#include "RunebergVR_TeleportGrid.h"
+#include "RunebergVR_TeleportAnchor.h"
+#include "RunebergVR_FixedTimestep.h"
 #include "RunebergVR_Teleporter.generated.h"
 
 // World fade settings
@@ -51,6 +55,14 @@ struct FWorldFadeSettings
 	bool bShouldFadeAudio = false;
 };
 
+// Running totals of the teleporter's work, for comparing perf captures across builds
+struct FRunebergVRTeleporterCounters
+{
+	uint32 Traces = 0;
+	uint32 NavQueries = 0;
+	uint32 ComponentsCreated = 0;
+};
+
 // Teleport Marker Movement Direction
 UENUM(BlueprintType)
 enum class EMoveDirectionEnum : uint8
@@ -75,20 +87,46 @@ protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
 
+	// Called when the game ends
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	bool IsNavPointReachable(const FVector& Point, FNavLocation& OutLocation, const FVector& Extent);
 
 public:	
 	// Called every frame
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	// Traces, nav queries and components created since this teleporter was created
+	const FRunebergVRTeleporterCounters& GetPerfCounters() const { return PerfCounters; }
 	
 	/** How much earlier than fade out duration should the pawn teleport */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - World Fade")
 	float FadeOutTeleportOffset = -1.f;
 
+	/** Stream in levels and textures at the destination before moving the pawn, fade in starts once the pawn has moved */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - World Fade")
+	bool bPreWarmDestination = false;
+
+	/** Max time (secs) to hold the teleport while the destination streams in */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - World Fade")
+	float PreWarmTimeout = 2.f;
+
+	/** Texture streaming boost for the destination while it is being pre-warmed */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - World Fade")
+	float PreWarmTextureBoost = 1.f;
+
 	/** These are the objects that the teleport beam will recognize as boundaries */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Teleport Beam Parameters")
 	TArray<TEnumAsByte<EObjectTypeQuery> > TeleportBoundary_ObjectTypes;
 
+	/** Trace the teleport beam against TeleportTraceChannel instead of the boundary object types, e.g. a channel only simple teleport proxy collision blocks */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Teleport Beam Parameters")
+	bool bTraceTeleportChannel = false;
+
+	/** Trace channel for the teleport beam when Trace Teleport Channel is on */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Teleport Beam Parameters")
+	TEnumAsByte<ECollisionChannel> TeleportTraceChannel = ECC_Visibility;
+
 	// The teleport beam's mesh
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Teleport Beam Parameters")
 	class UStaticMesh* TeleportBeamMesh = nullptr;
@@ -113,10 +151,62 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Teleport Beam Parameters")
 	FVector BeamHitNavMeshTolerance = FVector(10.f, 10.f, 10.f);
 
+	/** Optional baked teleport grid for this level - target checks only go to the nav mesh near nav mesh edges */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Teleport Beam Parameters")
+	URunebergVR_TeleportGrid* TeleportGrid = nullptr;
+
+	/** Also check that a path exists from the pawn to the target (async, cached per nav mesh poly) so disconnected nav mesh islands are rejected - targets are invalid until their path is known */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Teleport Beam Parameters")
+	bool bCheckPathReachability = false;
+
+	/** Min time in seconds between async path queries */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Teleport Beam Parameters")
+	float PathCheckInterval = 0.1f;
+
+	/** Rate (Hz) of the arc/ray targeting traces, rendering interpolates between results (e.g. 30). 0 traces every frame */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Teleport Beam Parameters")
+	float TargetingSimRate = 0.f;
+
 	/** The teleport beam's custom gravity */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Teleport Beam Parameters")
 	float ArcOverrideGravity = 0.f;
 
+	/** Pick the number of arc segments from the arc's length, curvature and distance to the HMD instead of a fixed rate */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Teleport Beam Parameters")
+	bool bAdaptiveArcResolution = false;
+
+	/** Fewest segments an adaptive arc will use */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Teleport Beam Parameters")
+	int32 ArcMinSegments = 8;
+
+	/** Most segments an adaptive arc will use */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Teleport Beam Parameters")
+	int32 ArcMaxSegments = 60;
+
+	/** Target length of an adaptive arc segment near the HMD, curved arcs get shorter segments */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Teleport Beam Parameters")
+	float ArcSegmentLength = 25.f;
+
+	/** Distance from the HMD at which adaptive arc segments double in length */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Teleport Beam Parameters")
+	float ArcLODDistance = 500.f;
+
+	/** Draw the teleport arc as a single procedural tube (one draw call) instead of a spline mesh per arc segment */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Teleport Beam Parameters")
+	bool bUseProceduralArcMesh = false;
+
+	/** Radius of the procedural teleport arc */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Teleport Beam Parameters")
+	float ArcTubeRadius = 1.f;
+
+	/** Number of sides of the procedural teleport arc - 2 draws a flat ribbon */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Teleport Beam Parameters")
+	int32 ArcTubeSides = 6;
+
+	/** Material of the procedural teleport arc - uses the teleport beam mesh's material if not set */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Teleport Beam Parameters")
+	class UMaterialInterface* ArcMaterial = nullptr;
+
 	// The teleport target stuff
 
 	/** Additional offset of pawn (internal offsets are Steam: 112, Rift: 250) */
@@ -141,6 +231,14 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Teleport Target Parameters")
 	bool bFaceMarkerRotation = false;
 
+	/** Snap the teleport target to the nearest teleport anchor around the beam hit location */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Teleport Target Parameters")
+	bool bSnapToTeleportAnchors = false;
+
+	/** How far from the beam hit location to look for a teleport anchor */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Teleport Target Parameters")
+	float AnchorSnapRadius = 150.f;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Teleport Target Parameters")
 	class UParticleSystem* TeleportTargetParticle = nullptr;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VR - Teleport Target Parameters")
@@ -195,6 +293,10 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "VR")
 	bool TeleportNow(FWorldFadeSettings FadeOutOptions, FWorldFadeSettings FadeInOptions, bool ForceTeleport = false, bool TeleportPhysics = false);
 
+	/** Editor utility - add simple box collision over the walkable surfaces of a static mesh that only blocks TraceChannel, for use with Trace Teleport Channel. Returns the number of boxes added */
+	UFUNCTION(BlueprintCallable, Category = "VR")
+	static int32 GenerateTeleportProxyCollision(UStaticMeshComponent* MeshComponent, TEnumAsByte<ECollisionChannel> TraceChannel, float MaxFloorAngle = 30.f, float CellSize = 50.f, float HeightTolerance = 10.f);
+
 private:
 	// Teleport target height offset - defaults to SteamVR
 	FVector PawnHeightOffset = FVector(0.f, 0.f, 112.f);
@@ -202,6 +304,9 @@ private:
 	// Teleport targetting mode
 	int TeleportMode = -1;
 
+	// Running work totals, see GetPerfCounters
+	FRunebergVRTeleporterCounters PerfCounters;
+
 	// Teleport Arc constants
 	const float ArcRadius = 0.f;
 	const float MaxSimTime = 2.f;
@@ -218,6 +323,12 @@ private:
 	float RayNumOfTimesToScale_Actual = 0.f;
 	float RayDistanceToTarget = 0.f;
 	
+	// Procedural teleport arc mesh - unused rings collapse onto the arc end so the section keeps its topology between frames
+	class UProceduralMeshComponent* ArcProceduralMesh = nullptr;
+	TArray<FVector> ArcMeshVertices;
+	TArray<FVector> ArcMeshNormals;
+	int32 ArcMeshRingCapacity = 0;
+
 	// TeleportRay mesh
 	UStaticMeshComponent* RayMesh = nullptr;
 
@@ -225,7 +336,20 @@ private:
 	FVector TargetLocation = FVector::ZeroVector;
 	FRotator TargetRotation = FRotator::ZeroRotator;
 
-	// Spawned visible components for targetting marker
+	// Fixed rate targeting simulation - latest and previous results, rendering interpolates between them
+	FVRFixedTimestep TargetingTimestep;
+	TArray<FVector> ArcSimPoints;
+	TArray<FVector> ArcSimPointsPrev;
+	FVector SimTargetLocation = FVector::ZeroVector;
+	FVector SimTargetLocationPrev = FVector::ZeroVector;
+	FRotator SimTargetRotation = FRotator::ZeroRotator;
+	FRotator SimTargetRotationPrev = FRotator::ZeroRotator;
+	bool bSimTargetWasValid = false;
+
+	// Flight time of the last arc trace, for adaptive arc resolution
+	float LastArcFlightTime = 0.f;
+
+	// Visible components for targetting marker (created once, reused)
 	UParticleSystemComponent* TargetParticleSystemComponent = nullptr;
 	UStaticMeshComponent* TargetStaticMeshComponent = nullptr;
 
@@ -234,14 +358,59 @@ private:
 	FVector TeleportTargetLoc = FVector::ZeroVector;
 	bool TeleportTargetPhys = false;
 
+	// Destination pre-warming
+	TArray<TWeakObjectPtr<ULevelStreaming>> PreWarmLevels;
+	FWorldFadeSettings PendingFadeIn;
+	float PreWarmStartTime = 0.f;
+	bool bIsPreWarming = false;
+
+	// Async path reachability - results per target poly, valid while the pawn stays on the same poly
+	TMap<uint64, bool> PathReachableCache;
+	NavNodeRef PathCacheStartPoly = INVALID_NAVNODEREF;
+	uint32 PendingPathQueryID = INVALID_NAVQUERYID;
+	uint64 PendingPathKey = 0;
+	NavNodeRef PendingPathStartPoly = INVALID_NAVNODEREF;
+	uint64 TargetPathKey = 0;
+	float LastPathQueryTime = -1.f;
+
+	// Trace the teleport arc and check the target location
+	void SimulateTeleportArc();
+
+	// Arc trace rate that gives the adaptive segment count, based on the last arc trace
+	float GetAdaptiveArcSimFrequency() const;
+
 	// Draw teleport arc
-	void DrawTeleportArc();
+	void DrawTeleportArc(float Alpha = 1.f);
 
 	// Clear teleport arc spline
 	void ClearTeleportArc();
 
+	// Build the teleport arc as a single procedural mesh section from ArcPoints
+	void DrawProceduralArc();
+
+	// Trace the teleport ray and check the target location
+	void SimulateTeleportRay();
+
 	// Draw teleport ray
-	void DrawTeleportRay();
+	void DrawTeleportRay(float Alpha = 1.f);
+
+	// Keep the latest targeting result as the one to interpolate from
+	void StoreSimResult();
+
+	// Restart the targeting simulation when a beam is shown
+	void ResetTargetingSim();
+
+	// Check (or start checking) if a nav location can be walked to from the pawn, false while the answer is still unknown
+	bool IsPathReachable(const FNavLocation& Destination);
+
+	// Async path query result
+	void OnPathQueryFinished(uint32 QueryID, ENavigationQueryResult::Type Result, FNavPathSharedPtr Path);
+
+	// Move the simulated target onto the nearest teleport anchor, returns false if there's none in range
+	bool SnapToTeleportAnchor(const FVector& HitLocation);
+
+	// Interpolate the target location and marker between the last two targeting results
+	void UpdateTargetMarker(float Alpha);
 
 	// Clear teleport arc spline
 	void ClearTeleportRay();
@@ -260,4 +429,13 @@ private:
 
 	// Teleport Pawn Event
 	void OnTeleport();
+
+	// Start streaming in levels and textures around the teleport destination
+	void StartPreWarm(const FVector& Destination);
+
+	// Check if everything requested by StartPreWarm is loaded and visible
+	bool IsDestinationResident() const;
+
+	// Resume normal level streaming after a pre-warmed teleport
+	void EndPreWarm();
 };
@@ -15,8 +15,25 @@ public class RunebergVRPlugin : ModuleRules
 
         PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "HeadMountedDisplay", "NavigationSystem" });
 
-        PrivateDependencyModuleNames.AddRange(new string[] { "Slate", "SlateCore" });
+        PrivateDependencyModuleNames.AddRange(new string[] { "Slate", "SlateCore", "ProceduralMeshComponent" });
 
         DynamicallyLoadedModuleNames.AddRange(new string[] { "RunebergVRPlugin" });
+
+        // Undo support for the editor utilities
+        if (Target.bBuildEditor)
+        {
+            PrivateDependencyModuleNames.Add("UnrealEd");
+        }
+
+        // Chaperone play area for the VR bounds check, read straight from OpenVR on platforms that have it
+        if (Target.Platform == UnrealTargetPlatform.Win64 || Target.Platform == UnrealTargetPlatform.Win32 || Target.Platform == UnrealTargetPlatform.Linux || Target.Platform == UnrealTargetPlatform.Mac)
+        {
+            AddEngineThirdPartyPrivateStaticDependencies(Target, "OpenVR");
+            PrivateDefinitions.Add("RUNEBERGVR_WITH_OPENVR=1");
+        }
+        else
+        {
+            PrivateDefinitions.Add("RUNEBERGVR_WITH_OPENVR=0");
+        }
     }
 }
\ No newline at end of file